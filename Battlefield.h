@@ -0,0 +1,1254 @@
+#pragma once
+
+#include "Common.h"
+#include "Scenario.h"
+#include "Metrics.h"
+#include "SpatialIndex.h"
+#include "FlowField.h"
+#include "Visibility.h"
+#include "Terrain.h"
+#include "Bitboard.h"
+#include "StepRandom.h"
+#include "Replay.h"
+#include "SharedState.h"
+#include "EventFeed.h"
+#include "Memory.h"
+#include "RenderPipeline.h"
+#include "ScriptProgram.h"
+#include "RobotSlots.h"
+
+/*Starting from here is all of the class definition
+xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+*/
+
+enum RobotModel {
+    MODEL_CLASSES,                                  //the hand written class per combination
+    MODEL_POLICY                                    //PolicyRobot<Move, Fire, Look>, abilities composed at compile time
+} ;
+
+enum DispatchMode {
+    DISPATCH_ROSTER,                                //roster order, one virtual takeTurn per robot
+    DISPATCH_BY_TYPE                                //grouped by concrete class, each group runs a non-virtual batch
+} ;
+
+enum AiMode {
+    AI_RANDOM,                                      //look, fire and move in random directions
+    AI_NEAREST,                                     //think() picks the nearest live robot, then look, fire and move at it
+    AI_FLOW                                         //as AI_NEAREST, but moves follow the battlefield's shared flow field
+} ;
+
+class Logger {
+    std::ofstream logFile;
+    bool enabled = true ;
+    std::string line ;                                   //message being assembled, reused so logging does not allocate
+    std::string* captured = nullptr ;
+
+    static void append(std::string& out, std::string_view text) { out.append(text) ; }
+    template<class Number, class = std::enable_if_t<std::is_integral<Number>::value>>
+    static void append(std::string& out, Number value) {
+        char digits[24] ;
+        out.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr) ;
+    }
+
+public:
+    Logger(const std::string& filename) ;                //empty filename: console only
+    ~Logger() ;
+
+    void setEnabled(bool state) { enabled = state ; }    //off: drop everything (benchmarks, lookahead copies)
+    bool isEnabled() const { return enabled ; }
+    void capture(std::string* buffer) { captured = buffer ; }   //non null: log() appends there instead of writing
+    void log(const std::string& message) ;
+    void emit(std::string_view text) ;                   //straight to the console and file, for the render thread
+    template<class... Parts> void log(const Parts&... parts) {     //log(name, " moves to (", x, ...) : text and integers
+        if(!enabled)
+            return ;
+        line.clear() ;
+        (append(line, parts), ...) ;
+        log(line) ;
+    }
+};
+
+class Battlefield {
+    int rows, cols, steps;
+    BoardFormatter board ;                          //display() output, reused between steps
+    std::string boardText ;
+    RenderPipeline pipeline ;
+    int pipelineDepth = 0 ;                         //0 : display() inline
+    std::string pendingLog ;                        //log text captured for the next pipelined frame
+    int tickRate = 0 ;                              //steps per second in real-time mode, 0 = as fast as possible
+    TickClock ticks ;
+    bool renderStep = true ;                        //false while a late real-time step skips its board
+    StepArena arena ;                               //transient per step memory, rewound after every step
+    RobotSlots robots;                              //roster, dense in turn order
+    std::pmr::unsynchronized_pool_resource rosterPool ;   //graveyard chunks and identity nodes, recycled as robots come and go
+    std::pmr::deque<RobotHandle> graveyard {&rosterPool} ;   //queue, its robots stay on the roster until revived or gone
+    std::vector<std::shared_ptr<const ScriptProgram>> scripts ;    //robots point into these, shared with forks
+    Logger* logger;
+    StepMetrics metrics ;
+
+    DispatchMode dispatchMode = DISPATCH_ROSTER ;
+    RobotModel robotModel = MODEL_CLASSES ;
+    bool bulkRandom = false ;
+    StepRandom stepRandom ;
+    ReplayWriter replay ;
+    SharedStateExport sharedState ;
+    std::vector<RobotRecord> frameRecords ;         //packed roster for replay and shared memory frames
+    SpatialIndex spatial ;
+    AiMode aiMode = AI_RANDOM ;
+    FlowField flowField ;
+    Visibility visibility ;
+    bool teamsInPlay = false ;
+    Terrain terrain ;
+    Bitboard bitboard ;                             //only on boards up to bitboardCells cells
+    int bitboardCells = BITBOARD_MAX_CELLS ;
+    bool ownRandom = false ;                        //rand_r on randomState instead of the shared rand()
+    unsigned randomState = 1 ;
+    int stepsRun = 0 ;
+    EventFeed* events = nullptr ;                   //spectators, not owned
+    bool kindStats = false ;
+    std::array<std::array<uint32_t, ACTION_COUNT>, size_t(RobotKind::COUNT)> kindActions {} ;
+    std::vector<std::pair<int,int>> objectives ;    //flow field goals, empty = head for the other robots
+    uint64_t stateHash = 0 ;                        //Zobrist hash of every robot on the roster
+    std::ofstream hashTrace ;                       //"step hash" per line when tracing
+    std::unordered_map<uint64_t, int> seenStates ;  //hash -> first step, to flag repeats in the trace
+    std::pmr::unordered_set<uint64_t> identities {&rosterPool} ;   //of the robots on the roster, all distinct
+    uint64_t rosterVersion = 0 ;                    //bumped whenever robots are added, removed or reordered
+    int rosterSortInterval = 0 ;                    //steps between Morton re-sorts of the roster, 0 = load order
+    uint64_t bucketVersion = ~0ull ;
+    std::vector<std::vector<Robot*>> turnBuckets ; //per RobotKind, in roster order
+
+    void placeLoadedRobot(std::string_view type, std::string_view name, int x, int y, int team, std::vector<bool>& taken, int& freeCells,
+                          const ScriptProgram* script = nullptr) ;
+    const ScriptProgram* findScript(std::string_view name) const ;    //latest definition, nullptr if none
+    void removeRobot(Robot* robot) ;
+    void rebuildTurnBuckets() ;
+    void sortRoster() ;
+    void resizeBoardIndexes() ;
+    void rebuildBitboard() ;
+    bool loadScenario(ScenarioReader& reader) ;
+    void publishFrame(int step) ;                  //replay, shared memory and hash trace consumers, after each step
+    void queueFrame(bool withBoard, bool withGraveyard) ;   //pipelined display(), captured log text goes first
+    bool runStep(int step, PhaseTimer& timer) ;    //false once the match is decided
+    void runTurns(int step, bool counted) ;
+
+public:
+    Battlefield(int r, int c, Logger* log = nullptr) : rows(r), cols(c) {           //board is formatted by display()
+        logger = log ? log : new Logger("log.txt") ;          //the battlefield owns its logger
+        spatial.reset(c, r) ;
+        flowField.reset(c, r) ;
+        visibility.reset(c, r) ;
+        terrain.reset(c, r) ;
+        if(r * c <= bitboardCells)
+            bitboard.reset(c, r) ;
+    }
+    Battlefield(const Battlefield&) = delete ;     //robots point back at their battlefield, copy with fork()
+    Battlefield& operator=(const Battlefield&) = delete ;
+    ~Battlefield();
+
+    int getRows() ;
+    int getCols() ;
+    int getSteps() ;
+    const std::vector<Robot*>& getRobots() const ;
+    Logger* getLogger() ;
+    StepMetrics& getMetrics() { return metrics ; }
+    std::pmr::memory_resource* getArena() { return &arena ; }
+    void noteAction(ActionType action, Robot* robot) ;
+    void noteMove(Robot* robot, int oldX, int oldY) ;
+    void toggleStateHash(uint64_t keys) { stateHash ^= keys ; }
+    uint64_t getStateHash() const { return stateHash ; }
+    uint64_t computeStateHash() const ;            //from scratch, to check the incremental one
+    bool startHashTrace(const std::string& filename) ;
+    const SpatialIndex& getSpatialIndex() const { return spatial ; }
+    FlowField& getFlowField() { return flowField ; }
+    const Visibility& getVisibility() const { return visibility ; }
+    const Terrain& getTerrain() const { return terrain ; }
+    void setTerrain(int x, int y, TerrainType type) ;
+    bool shotBlocked(int fromX, int fromY, int toX, int toY) const ;   //by a wall, or cover on the line or around the target
+    bool canEnter(int x, int y) ;                      //on the board, no wall, no robot : every move path asks this
+    bool canShoot(Robot* shooter, int targetX, int targetY) ;    //on the board and a clear line, logs why not
+    int chargeLength(int x, int y, int stepX, int stepY, int length) const ;    //how far a straight charge gets
+    bool hasTeams() const { return teamsInPlay ; }
+    bool addObjective(int x, int y) ;                  //false : the cell is off the loaded board
+    void refreshFlowField() ;
+    bool flowStep(const Robot* robot, int& dx, int& dy) ;     //best free neighbour downhill, false = stay
+    Robot* robotAt(int x, int y, int team = 0) const { return mayHaveRobot(x, y) ? spatial.robotAt(x, y, robots, team) : nullptr ; }
+    //false only when the bitboard proves there is no other robot there, true whenever a roster scan is needed
+    bool mayHaveRobot(int x, int y) const { return !bitboard.isActive() || bitboard.test(x, y) ; }
+    bool mayHaveRobotAround(int x, int y, const Robot* except) const ;                  //3 x 3 block
+    bool mayHaveRobotOnLine(int x0, int y0, int x1, int y1, const Robot* except) const ;    //row or column, x0 <= x1 and y0 <= y1
+    void setBitboardLimit(int cells) ;             //boards with more cells use the spatial index alone, 0 = never
+    bool usesBitboard() const { return bitboard.isActive() ; }
+
+    void setRows(int row) ;
+    void setCols(int col) ;
+    void setSteps(int step) ;
+    void setDispatchMode(DispatchMode mode) { dispatchMode = mode ; }
+    void setPipelineDepth(int depth) { pipelineDepth = std::max(depth, 0) ; }    //frames the render thread may lag
+    void setTickRate(int stepsPerSecond) { tickRate = std::max(stepsPerSecond, 0) ; }
+    void setRobotModel(RobotModel model) { robotModel = model ; }
+    void setBulkRandom(bool state) ;
+    void setRosterSortInterval(int interval) { rosterSortInterval = std::max(interval, 0) ; }   //changes turn order
+    void setAiMode(AiMode mode) { aiMode = mode ; }
+    AiMode getAiMode() const { return aiMode ; }
+    bool startReplay(const std::string& filename, int keyframeEvery) { return replay.open(filename, rows, cols, keyframeEvery) ; }
+    bool startSharedExport(const std::string& name, bool keep) ;
+    int roll(Robot* robot) ;                       //random draw for a robot's turn logic, same range as rand()
+    int nextRandom() { return ownRandom ? rand_r(&randomState) : rand() ; }
+    void setOwnRandom(bool state) { ownRandom = state ; }  //needed whenever battlefields run on several threads
+    void seedRandom(unsigned seed) ;
+    void setKindStats(bool state) { kindStats = state ; }  //count actions per robot kind
+    void setEventFeed(EventFeed* feed) { events = feed ; }
+    const std::array<uint32_t, ACTION_COUNT>& getKindActions(RobotKind kind) const { return kindActions[size_t(kind)] ; }
+    int getStepsRun() const { return stepsRun ; }
+    void clear() ;                                 //back to an empty board, keeping allocations for the next match
+    std::unique_ptr<Battlefield> fork(unsigned seed) const ;   //independent copy, silent and on its own random state
+    void forkInto(Battlefield& copy, unsigned seed) const ;    //same, reusing a scratch battlefield's allocations
+    int advance(int count) ;                       //run up to count more steps, returns how many ran
+    Robot* buildRobot(RobotKind kind, const std::string& name, int x, int y) ;
+
+    bool loadFromFile(const std::string& filename);   //false : unreadable or malformed, the reason is logged
+    bool loadFromText(std::string_view text) ;
+    bool loadFromBinary(const std::string& filename);
+    static bool compileScenario(const std::string& textFile, const std::string& binaryFile, uint32_t seed = 0);
+    void runSimulation();
+    void display();
+    bool isInside(int x, int y);
+    bool isOccupied(int x, int y);
+    void createRobot(Robot* robot);
+    void packRecords(std::vector<RobotRecord>& records) ;
+    void enterGraveyard(Robot* robot) ;
+    void reviveOne() ;
+    void upgrade(Robot* robot) ;
+    Robot* createUpgradedRobot(Robot* robot) ;
+    Battlefield& operator<<(Robot* robot) ; //operator overloading. basically this one will call createRobot() to insert
+};                                          //new robot into the vector. (bf << robot ;) it's like saying insert robot into battlefield
+
+/*Zobrist style state hash. every robot field on the roster contributes key(robot, field, value) and the battlefield
+keeps the XOR of all of them, so a change costs two keys. keys are computed (splitmix64 over the robot's name hash,
+the field and the value) rather than looked up, since positions and counters have no fixed range. robots are
+identified by a hash of their name, not the interned id, so runs in different processes hash alike. a robot whose
+name hash is already on the roster gets it remixed until unique, else two alike robots would cancel out*/
+enum StateField : uint8_t { STATE_PRESENT, STATE_KIND, STATE_POSITION, STATE_LIVES, STATE_REVIVALS, STATE_SHELLS,
+                            STATE_UPGRADE_POINTS, STATE_UPGRADES, STATE_TEAM } ;
+
+inline uint64_t stateKey(uint64_t identity, StateField field, int64_t value) {
+    uint64_t z = identity ^ (uint64_t(field) + 1) * 0xC2B2AE3D27D4EB4Full ^ uint64_t(value) * 0x9E3779B97F4A7C15ull ;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull ;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull ;
+    return z ^ (z >> 31) ;
+}
+
+uint64_t nameIdentity(std::string_view name) ;     //FNV-1a of the name
+
+class Robot {
+protected:
+    RobotKind kind ;
+    uint8_t upgrades = 0 ;                          //RobotRecord::UPGRADE_* bits
+    uint8_t team = 0 ;                              //0 = fights everyone
+    int16_t lives = 1;
+    int16_t revivals = 3 ;
+    int16_t upgradePoints = 0 ;
+    int16_t shells = 10 ;                           //owned by ShootingRobot, stored here to keep the record packed
+    uint32_t nameId ;
+    int posX, posY;
+    int32_t rollSlot = -1 ;                         //this step's StepRandom slot, -1 = none
+    uint32_t rollsUsed = 0 ;
+    bool hashed = false ;                           //on the roster, changes go into the battlefield's state hash
+    RobotHandle handle ;                            //roster slot, set by Battlefield::createRobot
+    const ScriptProgram* script = nullptr ;         //runs instead of the built-in turn, owned by the battlefield
+    uint64_t identity ;                             //nameIdentity(name), remixed by createRobot while not unique
+    Battlefield* battlefield ;
+
+    template<class Field> void setState(Field& field, int64_t value, StateField which) {
+        Field next = Field(value) ;
+        if(hashed && next != field)
+            battlefield->toggleStateHash(stateKey(identity, which, int64_t(field)) ^ stateKey(identity, which, int64_t(next))) ;
+        field = next ;
+    }
+    void setUpgrade(uint8_t bit, bool state) { setState(upgrades, state ? (upgrades | bit) : (upgrades & ~bit), STATE_UPGRADES) ; }
+    static int64_t packPosition(int x, int y) { return int64_t(y) << 32 | uint32_t(x) ; }
+
+public:
+    Robot(const std::string& t,const std::string& n, int x, int y , Battlefield* bf) :
+        kind(robotKindFromName(t)), nameId(NameTable::intern(n)), posX(x), posY(y) , identity(nameIdentity(n)), battlefield(bf) {}
+
+    virtual void takeTurn() = 0;
+    virtual bool isAlive() const { return lives > 0; }
+    bool canRevive() { return revivals > 0 ; }
+
+    const std::string& getType() const { return robotKindName(kind); }
+    const std::string& getName() const { return NameTable::name(nameId); }
+    RobotKind getKind() const { return kind ; }
+    Battlefield* getBattlefield() const { return battlefield ; }
+    int roll() { return battlefield->roll(this) ; }
+    void setRollSlot(int slot) { rollSlot = slot ; rollsUsed = 0 ; }
+    uint32_t takeRoll() { return rollsUsed++ ; }   //draws taken this step, the index of this one
+    int getRollSlot() const { return rollSlot ; }
+    uint32_t getNameId() const { return nameId ; }
+    RobotHandle getHandle() const { return handle ; }
+    const ScriptProgram* getScript() const { return script ; }
+    void setScript(const ScriptProgram* program) { script = program ; }
+    void setHandle(RobotHandle slot) { handle = slot ; }
+    int getX() const { return posX; }
+    int getY() const { return posY; }
+    int getRevivals() const { return revivals ; }
+    int getLives() const { return lives ; }
+    int getTeam() const { return team ; }
+    bool isTeamMate(const Robot* other) const { return team != 0 && other->team == team ; }    //never shot at or reported
+    bool getUpgradeFirst() { return upgrades & RobotRecord::UPGRADE_FIRST ; }
+    bool getUpgradeSecond() { return upgrades & RobotRecord::UPGRADE_SECOND ; }
+    bool getUpgradeThird() { return upgrades & RobotRecord::UPGRADE_THIRD ; }
+    int getUpgradePoints() { return upgradePoints ; }
+
+    void setType(std::string_view type) { setState(kind, int64_t(robotKindFromName(type)), STATE_KIND) ; }
+    void setName(const std::string& name) {       //every key depends on the name
+        if(hashed)
+            battlefield->toggleStateHash(stateHash()) ;
+        nameId = NameTable::intern(name) ;
+        identity = nameIdentity(name) ;
+        if(hashed)
+            battlefield->toggleStateHash(stateHash()) ;
+    }
+    uint64_t getIdentity() const { return identity ; }
+    void setIdentity(uint64_t value) {              //before joining the roster, see Battlefield::createRobot
+        if(hashed)
+            battlefield->toggleStateHash(stateHash()) ;
+        identity = value ;
+        if(hashed)
+            battlefield->toggleStateHash(stateHash()) ;
+    }
+    void setRevivals(int revival) { setState(revivals, revival, STATE_REVIVALS) ; }
+    void setTeam(int teamId) { setState(team, teamId, STATE_TEAM) ; }
+    void setPosition(int x, int y) {
+        if(x == posX && y == posY)
+            return ;
+        battlefield->noteAction(ACTION_MOVE, this) ;
+        int oldX = posX, oldY = posY ;
+        if(hashed)
+            battlefield->toggleStateHash(stateKey(identity, STATE_POSITION, packPosition(oldX, oldY)) ^ stateKey(identity, STATE_POSITION, packPosition(x, y))) ;
+        posX = x; posY = y;
+        battlefield->noteMove(this, oldX, oldY) ;
+    }
+    void setLives(int live) { setState(lives, live, STATE_LIVES) ; }
+    void setUpgradeFirst(const bool state) { setUpgrade(RobotRecord::UPGRADE_FIRST, state) ; }
+    void setUpgradeSecond(bool state) { setUpgrade(RobotRecord::UPGRADE_SECOND, state) ; }
+    void setUpgradeThird(bool state) { setUpgrade(RobotRecord::UPGRADE_THIRD, state) ; }
+    void setUpgradePoints(int upgradePoint) { setState(upgradePoints, upgradePoint, STATE_UPGRADE_POINTS) ; }
+
+    void subRevivals() { setState(revivals, revivals - 1, STATE_REVIVALS) ; }
+    void addRevivals() { setState(revivals, revivals + 1, STATE_REVIVALS) ; }
+    void addLives() { setState(lives, lives + 1, STATE_LIVES) ; }
+    void subLives() { setState(lives, lives - 1, STATE_LIVES) ; }
+    void addUpgradePoints() { setState(upgradePoints, upgradePoints + 1, STATE_UPGRADE_POINTS) ; }
+    void subUpgradePoints() { setState(upgradePoints, upgradePoints - 1, STATE_UPGRADE_POINTS) ; }
+    virtual void takeDamage() {
+        battlefield->noteAction(ACTION_HIT, this) ;
+        subLives() ;
+        battlefield->getLogger()->log(getName(), " is taking damage!\n") ;
+    }
+    void kill() { setLives(0) ; }
+    virtual void reset() { setLives(1) ; }
+
+    uint64_t stateHash() const ;                   //XOR of every field's key, what this robot adds to the battlefield hash
+    void setHashed(bool state) { hashed = state ; }
+    virtual Robot* clone(Battlefield* bf) const ;  //exact copy of the concrete robot, living on bf
+
+    RobotRecord toRecord() const {
+        RobotRecord record ;
+        record.nameId = nameId ;
+        record.x = posX ;
+        record.y = posY ;
+        record.kind = kind ;
+        record.flags = upgrades | (isAlive() ? RobotRecord::ALIVE : 0) ;
+        record.lives = std::max(-128, std::min<int>(127, lives)) ;
+        record.revivals = std::max(-128, std::min<int>(127, revivals)) ;
+        record.shells = shells ;
+        record.upgradePoints = upgradePoints ;
+        record.slot = handle.index ;
+        return record ;
+    }
+
+    static void* operator new(size_t bytes) { return RobotPool::allocate(bytes) ; }
+    static void operator delete(void* block, size_t bytes) { RobotPool::release(block, bytes) ; }
+    virtual ~Robot() = default;
+};
+
+inline void Battlefield::noteAction(ActionType action, Robot* robot) {
+    metrics.countAction(action) ;
+    if(kindStats)
+        kindActions[size_t(robot->getKind())][action]++ ;
+    if(events && action != ACTION_LOOK) {
+        static const GameEventType eventOf[ACTION_COUNT] = {EVENT_MOVE, EVENT_SHOT, EVENT_HIT, EVENT_COUNT, EVENT_UPGRADE, EVENT_REVIVE} ;
+        events->publish(eventOf[action], stepsRun, robot->getNameId(), robot->getX(), robot->getY(), robot->getKind()) ;
+    }
+}
+
+class MovingRobot : virtual public Robot {
+protected:
+    bool wading = false ;                           //spent a turn getting out of slow terrain
+
+public:
+    using Robot::Robot;
+    virtual void move(int dx, int dy) ;
+    bool wade() ;                                   //true : this turn goes to getting out of slow terrain
+    virtual ~MovingRobot() = default;
+};
+
+class ShootingRobot : virtual public Robot {
+public:
+    using Robot::Robot;
+    virtual void fire(int dx, int dy) ;
+    int getShells() ;
+    void setShells(int shell) ;
+    void addShells() { setState(shells, shells + 1, STATE_SHELLS) ; }
+    void subShells() {
+        setState(shells, shells - 1, STATE_SHELLS) ;
+        battlefield->noteAction(ACTION_SHOT, this) ;
+    }
+    virtual ~ShootingRobot() = default;
+};
+
+class SeeingRobot : virtual public Robot {
+public:
+    using Robot::Robot;
+    virtual void look(int dx, int dy) ;
+    bool teamLook(std::pmr::vector<Robot*>* found = nullptr) ;     //report what the team sees, false when not on a team
+    virtual ~SeeingRobot() = default;
+};
+
+class ThinkingRobot : virtual public Robot {
+protected:
+    bool hasTarget = false ;                        //set by think() under AI_NEAREST
+    int targetX = 0, targetY = 0 ;
+
+public:
+    using Robot::Robot;
+    virtual void think() ;
+    void aimLook(int& dx, int& dy) const ;          //replace this turn's random direction with one toward the target
+    void aimFire(int& dx, int& dy) const ;
+    void aimMove(int& dx, int& dy) const ;
+    bool getTarget(int& x, int& y) const { x = targetX ; y = targetY ; return hasTarget ; }
+    virtual ~ThinkingRobot() = default;
+};
+
+class GenericRobot : virtual public MovingRobot, virtual public ShootingRobot, virtual public SeeingRobot, virtual public ThinkingRobot {
+public:
+    GenericRobot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          MovingRobot(), ShootingRobot(), SeeingRobot(), ThinkingRobot() {}
+
+    void takeTurn() override ;
+    void reset() override ;
+
+    template<class T, bool Bound = true> static void takeTurnDirect(T* self) ;    //the turn itself, calls bound to T at compile time
+
+};
+
+/*Ability policies. every single-ability class below delegates to one of these, and PolicyRobot composes
+one of each kind at compile time. each policy works on the robot it belongs to through self*/
+
+struct StepMove {                                   //MovingRobot::move and the normal takeDamage
+    void move(GenericRobot& self, int dx, int dy) ;
+    void takeDamage(GenericRobot& self) ;
+};
+
+struct HideMove : StepMove {
+    int remainingHides = 3;
+
+    bool canHide() { return remainingHides > 0 ; }
+    void takeDamage(GenericRobot& self) ;
+};
+
+struct JumpMove : StepMove {
+    int remainingJumps = 3;
+
+    bool canJump() { return remainingJumps > 0 ; }
+    void move(GenericRobot& self, int dx, int dy) ;
+};
+
+struct JuggernautMove : StepMove {
+    static const std::string directions[4] ;
+
+    void move(GenericRobot& self, int dx, int dy) ;
+};
+
+struct BasicFire {                                  //ShootingRobot::fire
+    static const int SHELLS = 10 ;
+    void fire(GenericRobot& self, int dx, int dy) ;
+};
+
+struct ThirtyshotFire : BasicFire {
+    static const int SHELLS = 30 ;
+};
+
+struct TrueDamageFire : BasicFire {
+    void fire(GenericRobot& self, int dx, int dy) ;
+};
+
+struct LifestealFire : BasicFire {
+    void fire(GenericRobot& self, int dx, int dy) ;
+};
+
+struct LongshotFire : BasicFire {
+    void fire(GenericRobot& self, int dx, int dy) ;
+};
+
+struct SemiautoFire : BasicFire {
+    void fire(GenericRobot& self, int dx, int dy) ;
+};
+
+struct BasicLook {                                  //SeeingRobot::look
+    void look(GenericRobot& self, int dx, int dy) ;
+};
+
+struct ScoutLook {
+    int remainingScans = 3 ;
+
+    void look(GenericRobot& self, int dx, int dy) ;
+};
+
+struct TrackerLook {
+    static const int TRACKERS = 3 ;
+    int remainingTracker = TRACKERS ;
+    std::array<uint32_t, TRACKERS> trackedNameIds ; //first TRACKERS - remainingTracker are in use
+
+    void look(GenericRobot& self, int dx, int dy) ;
+};
+
+template<class MovePolicy, class FirePolicy, class LookPolicy>
+class PolicyRobot final : public GenericRobot {
+private:
+    MovePolicy mover ;
+    FirePolicy gun ;
+    LookPolicy eyes ;
+
+public:
+    PolicyRobot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {
+        setShells(FirePolicy::SHELLS) ;
+    }
+
+    void move(int dx, int dy) override { mover.move(*this, dx, dy) ; }
+    void fire(int dx, int dy) override { gun.fire(*this, dx, dy) ; }
+    void look(int dx, int dy) override { eyes.look(*this, dx, dy) ; }
+    void takeDamage() override { mover.takeDamage(*this) ; }
+    void takeTurn() override { takeTurnDirect(this) ; }     //policy calls resolve statically and inline
+    Robot* clone(Battlefield* bf) const override {
+        PolicyRobot* copy = new PolicyRobot(*this) ;
+        copy->battlefield = bf ;
+        return copy ;
+    }
+};
+
+Robot* createPolicyRobot(RobotKind kind, const std::string& name, int x, int y, Battlefield* bf) ;
+
+class HideBot : virtual public GenericRobot {                //override takeDamage()
+private:
+    HideMove hider ;
+public:
+    HideBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {}
+
+    bool canHide() { return hider.canHide() ; }
+    void takeDamage() override { hider.takeDamage(*this) ; }
+};
+
+class JumpBot : virtual public GenericRobot {       //override move()
+private:
+    JumpMove jumper ;
+
+public:
+    JumpBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {}
+
+    void move(int dx, int dy) override { jumper.move(*this, dx, dy) ; }
+
+    bool canJump() { return jumper.canJump() ; }
+};
+
+class JuggernautBot : virtual public GenericRobot {
+private:
+    JuggernautMove charger ;
+
+public:
+    JuggernautBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {}
+
+    void move(int dx, int dy) override { charger.move(*this, dx, dy) ; }
+};
+
+class TrueDamageBot : virtual public GenericRobot {
+public:
+    TrueDamageBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {
+        setType("TrueDamageBot") ;
+    }
+
+    void fire(int dx, int dy) override { TrueDamageFire().fire(*this, dx, dy) ; }
+};
+
+class LifestealBot : virtual public GenericRobot {
+public:
+    LifestealBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {
+        setType("LifestealBot") ;
+    }
+
+    void fire(int dx, int dy) override { LifestealFire().fire(*this, dx, dy) ; }
+};
+
+class LongshotBot : virtual public GenericRobot {
+public:
+    LongshotBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {
+        setType("LongshotBot") ;
+    }
+
+    void fire(int dx, int dy) override { LongshotFire().fire(*this, dx, dy) ; }
+};
+
+class ThirtyshotBot : virtual public GenericRobot {
+public:
+    ThirtyshotBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {
+        setShells(ThirtyshotFire::SHELLS);         // replace current shell count with 30
+    }
+};
+
+class SemiautoBot : virtual public GenericRobot {
+public:
+    SemiautoBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {
+        setType("SemiautoBot") ;
+    }
+
+    void fire(int dx, int dy) override { SemiautoFire().fire(*this, dx, dy) ; }
+};
+
+class ScoutBot : virtual public GenericRobot {
+private:
+    ScoutLook scanner ;
+public:
+    ScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {
+        setType("ScoutBot") ;
+    }
+
+    void look(int dx, int dy) override { scanner.look(*this, dx, dy) ; }
+};
+
+class TrackerBot : virtual public GenericRobot {
+private:
+    TrackerLook tracker ;
+public:
+    TrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {
+        setType("TrackerBot") ;
+    }
+
+    void look(int dx, int dy) override { tracker.look(*this, dx, dy) ; }
+};
+
+class HideLongshotBot : virtual public HideBot, virtual public LongshotBot {
+public:
+    HideLongshotBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), HideBot(type, name, x, y, bf), LongshotBot(type, name, x, y, bf) {
+        setType("HideLongshotBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class HideSemiautoBot : virtual public HideBot, virtual public SemiautoBot {
+public:
+    HideSemiautoBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), HideBot(type, name, x, y, bf), SemiautoBot(type, name, x, y, bf) {
+        setType("HideSemiautoBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class HideThirtyshotBot : virtual public HideBot, virtual public ThirtyshotBot {
+public:
+    HideThirtyshotBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), HideBot(type, name, x, y, bf), ThirtyshotBot(type, name, x, y, bf) {
+        setType("HideThirtyshotBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class HideTrueDamageBot : virtual public HideBot, virtual public TrueDamageBot {
+public:
+    HideTrueDamageBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), HideBot(type, name, x, y, bf), TrueDamageBot(type, name, x, y, bf) {
+        setType("HideTrueDamageBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class HideLifestealBot : virtual public HideBot, virtual public LifestealBot {
+public:
+    HideLifestealBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), HideBot(type, name, x, y, bf), LifestealBot(type, name, x, y, bf) {
+        setType("HideLifestealBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JumpLongshotBot : virtual public JumpBot, virtual public LongshotBot {
+public:
+    JumpLongshotBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JumpBot(type, name, x, y, bf), LongshotBot(type, name, x, y, bf) {
+        setType("JumpLongshotBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JumpSemiautoBot : virtual public JumpBot, virtual public SemiautoBot {
+public:
+    JumpSemiautoBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JumpBot(type, name, x, y, bf), SemiautoBot(type, name, x, y, bf) {
+        setType("JumpSemiautoBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JumpThirtyshotBot : virtual public JumpBot, virtual public ThirtyshotBot {
+public:
+    JumpThirtyshotBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JumpBot(type, name, x, y, bf), ThirtyshotBot(type, name, x, y, bf) {
+        setType("JumpThirtyshotBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JumpTrueDamageBot : virtual public JumpBot, virtual public TrueDamageBot {
+public:
+    JumpTrueDamageBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JumpBot(type, name, x, y, bf), TrueDamageBot(type, name, x, y, bf) {
+        setType("JumpTrueDamageBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JumpLifestealBot : virtual public JumpBot, virtual public LifestealBot {
+public:
+    JumpLifestealBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JumpBot(type, name, x, y, bf), LifestealBot(type, name, x, y, bf) {
+        setType("JumpLifestealBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JuggernautLongshotBot : virtual public JuggernautBot, virtual public LongshotBot {
+public:
+    JuggernautLongshotBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JuggernautBot(type, name, x, y, bf), LongshotBot(type, name, x, y, bf) {
+        setType("JuggernautLongshotBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JuggernautSemiautoBot : virtual public JuggernautBot, virtual public SemiautoBot {
+public:
+    JuggernautSemiautoBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JuggernautBot(type, name, x, y, bf), SemiautoBot(type, name, x, y, bf) {
+        setType("JuggernautSemiautoBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JuggernautThirtyshotBot : virtual public JuggernautBot, virtual public ThirtyshotBot {
+public:
+    JuggernautThirtyshotBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JuggernautBot(type, name, x, y, bf), ThirtyshotBot(type, name, x, y, bf) {
+        setType("JuggernautThirtyshotBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JuggernautTrueDamageBot : virtual public JuggernautBot, virtual public TrueDamageBot {
+public:
+    JuggernautTrueDamageBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JuggernautBot(type, name, x, y, bf), TrueDamageBot(type, name, x, y, bf) {
+        setType("JuggernautTrueDamageBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JuggernautLifestealBot : virtual public JuggernautBot, virtual public LifestealBot {
+public:
+    JuggernautLifestealBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JuggernautBot(type, name, x, y, bf), LifestealBot(type, name, x, y, bf) {
+        setType("JuggernautLifestealBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class HideLongshotScoutBot : virtual public HideLongshotBot, virtual public ScoutBot {
+public:
+    HideLongshotScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          HideBot(type, name, x, y, bf),
+          LongshotBot(type, name, x, y, bf),
+          HideLongshotBot(type, name, x, y, bf),
+          ScoutBot(type, name, x, y, bf) {
+        setType("HideLongshotScoutBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class HideLongshotTrackerBot : virtual public HideLongshotBot, virtual public TrackerBot {
+public:
+    HideLongshotTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          HideBot(type, name, x, y, bf),
+          LongshotBot(type, name, x, y, bf),
+          HideLongshotBot(type, name, x, y, bf),
+          TrackerBot(type, name, x, y, bf) {
+        setType("HideLongshotTrackerBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class HideSemiautoScoutBot : virtual public HideSemiautoBot, virtual public ScoutBot {
+public:
+    HideSemiautoScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          HideBot(type, name, x, y, bf),
+          SemiautoBot(type, name, x, y, bf),
+          HideSemiautoBot(type, name, x, y, bf),
+          ScoutBot(type, name, x, y, bf) {
+        setType("HideSemiautoScoutBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class HideSemiautoTrackerBot : virtual public HideSemiautoBot, virtual public TrackerBot {
+public:
+    HideSemiautoTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          HideBot(type, name, x, y, bf),
+          SemiautoBot(type, name, x, y, bf),
+          HideSemiautoBot(type, name, x, y, bf),
+          TrackerBot(type, name, x, y, bf) {
+        setType("HideSemiautoTrackerBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class HideThirtyshotScoutBot : virtual public HideThirtyshotBot, virtual public ScoutBot {
+public:
+    HideThirtyshotScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          HideBot(type, name, x, y, bf),
+          ThirtyshotBot(type, name, x, y, bf),
+          HideThirtyshotBot(type, name, x, y, bf),
+          ScoutBot(type, name, x, y, bf) {
+        setType("HideThirtyshotScoutBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class HideThirtyshotTrackerBot : virtual public HideThirtyshotBot, virtual public TrackerBot {
+public:
+    HideThirtyshotTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          HideBot(type, name, x, y, bf),
+          ThirtyshotBot(type, name, x, y, bf),
+          HideThirtyshotBot(type, name, x, y, bf),
+          TrackerBot(type, name, x, y, bf) {
+        setType("HideThirtyshotTrackerBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class HideTrueDamageScoutBot : virtual public HideTrueDamageBot, virtual public ScoutBot {
+public:
+    HideTrueDamageScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          HideBot(type, name, x, y, bf),
+          TrueDamageBot(type, name, x, y, bf),
+          HideTrueDamageBot(type, name, x, y, bf),
+          ScoutBot(type, name, x, y, bf) {
+        setType("HideTrueDamageScoutBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class HideTrueDamageTrackerBot : virtual public HideTrueDamageBot, virtual public TrackerBot {
+public:
+    HideTrueDamageTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          HideBot(type, name, x, y, bf),
+          TrueDamageBot(type, name, x, y, bf),
+          HideTrueDamageBot(type, name, x, y, bf),
+          TrackerBot(type, name, x, y, bf) {
+        setType("HideTrueDamageTrackerBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class HideLifestealScoutBot : virtual public HideLifestealBot, virtual public ScoutBot {
+public:
+    HideLifestealScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          HideBot(type, name, x, y, bf),
+          LifestealBot(type, name, x, y, bf),
+          HideLifestealBot(type, name, x, y, bf),
+          ScoutBot(type, name, x, y, bf) {
+        setType("HideLifestealScoutBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class HideLifestealTrackerBot : virtual public HideLifestealBot, virtual public TrackerBot {
+public:
+    HideLifestealTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          HideBot(type, name, x, y, bf),
+          LifestealBot(type, name, x, y, bf),
+          HideLifestealBot(type, name, x, y, bf),
+          TrackerBot(type, name, x, y, bf) {
+        setType("HideLifestealTrackerBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JumpLongshotScoutBot : virtual public JumpLongshotBot, virtual public ScoutBot {
+public:
+    JumpLongshotScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JumpBot(type, name, x, y, bf),
+          LongshotBot(type, name, x, y, bf),
+          JumpLongshotBot(type, name, x, y, bf),
+          ScoutBot(type, name, x, y, bf) {
+        setType("JumpLongshotScoutBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JumpLongshotTrackerBot : virtual public JumpLongshotBot, virtual public TrackerBot {
+public:
+    JumpLongshotTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JumpBot(type, name, x, y, bf),
+          LongshotBot(type, name, x, y, bf),
+          JumpLongshotBot(type, name, x, y, bf),
+          TrackerBot(type, name, x, y, bf) {
+        setType("JumpLongshotTrackerBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JumpSemiautoScoutBot : virtual public JumpSemiautoBot, virtual public ScoutBot {
+public:
+    JumpSemiautoScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JumpBot(type, name, x, y, bf),
+          SemiautoBot(type, name, x, y, bf),
+          JumpSemiautoBot(type, name, x, y, bf),
+          ScoutBot(type, name, x, y, bf) {
+        setType("JumpSemiautoScoutBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JumpSemiautoTrackerBot : virtual public JumpSemiautoBot, virtual public TrackerBot {
+public:
+    JumpSemiautoTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JumpBot(type, name, x, y, bf),
+          SemiautoBot(type, name, x, y, bf),
+          JumpSemiautoBot(type, name, x, y, bf),
+          TrackerBot(type, name, x, y, bf) {
+        setType("JumpSemiautoTrackerBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JumpThirtyshotScoutBot : virtual public JumpThirtyshotBot, virtual public ScoutBot {
+public:
+    JumpThirtyshotScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JumpBot(type, name, x, y, bf),
+          ThirtyshotBot(type, name, x, y, bf),
+          JumpThirtyshotBot(type, name, x, y, bf),
+          ScoutBot(type, name, x, y, bf) {
+        setType("JumpThirtyshotScoutBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JumpThirtyshotTrackerBot : virtual public JumpThirtyshotBot, virtual public TrackerBot {
+public:
+    JumpThirtyshotTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JumpBot(type, name, x, y, bf),
+          ThirtyshotBot(type, name, x, y, bf),
+          JumpThirtyshotBot(type, name, x, y, bf),
+          TrackerBot(type, name, x, y, bf) {
+        setType("JumpThirtyshotTrackerBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JumpTrueDamageScoutBot : virtual public JumpTrueDamageBot, virtual public ScoutBot {
+public:
+    JumpTrueDamageScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JumpBot(type, name, x, y, bf),
+          TrueDamageBot(type, name, x, y, bf),
+          JumpTrueDamageBot(type, name, x, y, bf),
+          ScoutBot(type, name, x, y, bf) {
+        setType("JumpTrueDamageScoutBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JumpTrueDamageTrackerBot : virtual public JumpTrueDamageBot, virtual public TrackerBot {
+public:
+    JumpTrueDamageTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JumpBot(type, name, x, y, bf),
+          TrueDamageBot(type, name, x, y, bf),
+          JumpTrueDamageBot(type, name, x, y, bf),
+          TrackerBot(type, name, x, y, bf) {
+        setType("JumpTrueDamageTrackerBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JumpLifestealScoutBot : virtual public JumpLifestealBot, virtual public ScoutBot {
+public:
+    JumpLifestealScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JumpBot(type, name, x, y, bf),
+          LifestealBot(type, name, x, y, bf),
+          JumpLifestealBot(type, name, x, y, bf),
+          ScoutBot(type, name, x, y, bf) {
+        setType("JumpLifestealScoutBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JumpLifestealTrackerBot : virtual public JumpLifestealBot, virtual public TrackerBot {
+public:
+    JumpLifestealTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JumpBot(type, name, x, y, bf),
+          LifestealBot(type, name, x, y, bf),
+          JumpLifestealBot(type, name, x, y, bf),
+          TrackerBot(type, name, x, y, bf) {
+        setType("JumpLifestealTrackerBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JuggernautLongshotScoutBot : virtual public JuggernautLongshotBot, virtual public ScoutBot {
+public:
+    JuggernautLongshotScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JuggernautBot(type, name, x, y, bf),
+          LongshotBot(type, name, x, y, bf),
+          JuggernautLongshotBot(type, name, x, y, bf),
+          ScoutBot(type, name, x, y, bf) {
+        setType("JuggernautLongshotScoutBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JuggernautLongshotTrackerBot : virtual public JuggernautLongshotBot, virtual public TrackerBot {
+public:
+    JuggernautLongshotTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JuggernautBot(type, name, x, y, bf),
+          LongshotBot(type, name, x, y, bf),
+          JuggernautLongshotBot(type, name, x, y, bf),
+          TrackerBot(type, name, x, y, bf) {
+        setType("JuggernautLongshotTrackerBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JuggernautSemiautoScoutBot : virtual public JuggernautSemiautoBot, virtual public ScoutBot {
+public:
+    JuggernautSemiautoScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JuggernautBot(type, name, x, y, bf),
+          SemiautoBot(type, name, x, y, bf),
+          JuggernautSemiautoBot(type, name, x, y, bf),
+          ScoutBot(type, name, x, y, bf) {
+        setType("JuggernautSemiautoScoutBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JuggernautSemiautoTrackerBot : virtual public JuggernautSemiautoBot, virtual public TrackerBot {
+public:
+    JuggernautSemiautoTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JuggernautBot(type, name, x, y, bf),
+          SemiautoBot(type, name, x, y, bf),
+          JuggernautSemiautoBot(type, name, x, y, bf),
+          TrackerBot(type, name, x, y, bf) {
+        setType("JuggernautSemiautoTrackerBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JuggernautThirtyshotScoutBot : virtual public JuggernautThirtyshotBot, virtual public ScoutBot {
+public:
+    JuggernautThirtyshotScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JuggernautBot(type, name, x, y, bf),
+          ThirtyshotBot(type, name, x, y, bf),
+          JuggernautThirtyshotBot(type, name, x, y, bf),
+          ScoutBot(type, name, x, y, bf) {
+        setType("JuggernautThirtyshotScoutBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JuggernautThirtyshotTrackerBot : virtual public JuggernautThirtyshotBot, virtual public TrackerBot {
+public:
+    JuggernautThirtyshotTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JuggernautBot(type, name, x, y, bf),
+          ThirtyshotBot(type, name, x, y, bf),
+          JuggernautThirtyshotBot(type, name, x, y, bf),
+          TrackerBot(type, name, x, y, bf) {
+        setType("JuggernautThirtyshotTrackerBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JuggernautTrueDamageScoutBot : virtual public JuggernautTrueDamageBot, virtual public ScoutBot {
+public:
+    JuggernautTrueDamageScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JuggernautBot(type, name, x, y, bf),
+          TrueDamageBot(type, name, x, y, bf),
+          JuggernautTrueDamageBot(type, name, x, y, bf),
+          ScoutBot(type, name, x, y, bf) {
+        setType("JuggernautTrueDamageScoutBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JuggernautTrueDamageTrackerBot : virtual public JuggernautTrueDamageBot, virtual public TrackerBot {
+public:
+    JuggernautTrueDamageTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JuggernautBot(type, name, x, y, bf),
+          TrueDamageBot(type, name, x, y, bf),
+          JuggernautTrueDamageBot(type, name, x, y, bf),
+          TrackerBot(type, name, x, y, bf) {
+        setType("JuggernautTrueDamageTrackerBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JuggernautLifestealScoutBot : virtual public JuggernautLifestealBot, virtual public ScoutBot {
+public:
+    JuggernautLifestealScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JuggernautBot(type, name, x, y, bf),
+          LifestealBot(type, name, x, y, bf),
+          JuggernautLifestealBot(type, name, x, y, bf),
+          ScoutBot(type, name, x, y, bf) {
+        setType("JuggernautLifestealScoutBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
+
+class JuggernautLifestealTrackerBot : virtual public JuggernautLifestealBot, virtual public TrackerBot {
+public:
+    JuggernautLifestealTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
+        : Robot(type, name, x, y, bf),
+          GenericRobot(type, name, x, y, bf),
+          JuggernautBot(type, name, x, y, bf),
+          LifestealBot(type, name, x, y, bf),
+          JuggernautLifestealBot(type, name, x, y, bf),
+          TrackerBot(type, name, x, y, bf) {
+        setType("JuggernautLifestealTrackerBot") ;
+    }
+
+    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
+};
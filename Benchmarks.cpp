@@ -0,0 +1,88 @@
+#include "Benchmarks.h"
+#include "Battlefield.h"
+
+void benchmarkRobotModels(int rounds) {               //per turn cost, class hierarchy vs PolicyRobot vs a script
+    const RobotModel models[] = {MODEL_CLASSES, MODEL_POLICY, MODEL_CLASSES} ;
+    const char* labels[] = {"classes", "policy", "script"} ;
+
+    //GenericRobot::takeTurn as a script, same calls and the same random draws
+    static const char* const builtinTurn =
+        "think\n"
+        "rand r0 3\n addi r0 r0 -1\n rand r1 3\n addi r1 r1 -1\n aimlook r0 r1\n look r0 r1\n"
+        "rand r0 3\n addi r0 r0 -1\n rand r1 3\n addi r1 r1 -1\n aimfire r0 r1\n fire r0 r1\n"
+        "rand r0 3\n addi r0 r0 -1\n rand r1 3\n addi r1 r1 -1\n aimmove r0 r1\n move r0 r1\n" ;
+    ScriptProgram script("builtin") ;
+    std::string error ;
+    script.assemble(builtinTurn, error) ;
+
+    for (int m = 0 ; m < 3 ; m++) {
+        Battlefield battlefield(MAX_ROWS, MAX_COLS) ;
+        battlefield.getLogger()->setEnabled(false) ;
+        battlefield.setRobotModel(models[m]) ;
+
+        int placed = 0 ;                                      //four of every kind, spread over the board
+        for (int copy = 0 ; copy < 4 ; copy++) {
+            for (int k = 0 ; k < static_cast<int>(RobotKind::COUNT) ; k++, placed++) {
+                battlefield << battlefield.buildRobot(RobotKind(k), "B" + std::to_string(placed), (placed * 7) % MAX_COLS, (placed * 13) % MAX_ROWS) ;
+            }
+        }
+        if (m == 2) {
+            for (Robot* robot : battlefield.getRobots())
+                robot->setScript(&script) ;
+        }
+
+        srand(1) ;
+        long long turns = 0 ;
+        auto start = std::chrono::steady_clock::now() ;
+        for (int round = 0 ; round < rounds ; round++) {
+            for (Robot* robot : battlefield.getRobots()) {
+                if (!robot->isAlive())
+                    robot->reset() ;
+                robot->takeTurn() ;
+                turns++ ;
+            }
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() ;
+
+        std::cout << labels[m] << ": " << turns << " turns, " << (turns ? elapsed / turns : 0) << " ns/turn\n" ;
+    }
+}
+
+//lookahead cost on the loaded scenario : fork the battlefield, run the copy a few steps, throw it away.
+//every thread forks from the same untouched original
+void benchmarkForks(Battlefield& battlefield, int forks, int depth) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency()) ;
+    std::vector<RobotRecord> before, after ;
+    battlefield.packRecords(before) ;
+
+    std::atomic<int> next {0} ;
+    std::atomic<long long> forkNs {0}, advanceNs {0}, stepsRun {0} ;
+    auto worker = [&]() {
+        Battlefield scratch(battlefield.getRows(), battlefield.getCols(), new Logger("")) ;
+        for(int i = next++ ; i < forks ; i = next++) {
+            auto start = std::chrono::steady_clock::now() ;
+            battlefield.forkInto(scratch, i + 1) ;
+            auto forked = std::chrono::steady_clock::now() ;
+            stepsRun += scratch.advance(depth) ;
+            auto done = std::chrono::steady_clock::now() ;
+            forkNs += std::chrono::duration_cast<std::chrono::nanoseconds>(forked - start).count() ;
+            advanceNs += std::chrono::duration_cast<std::chrono::nanoseconds>(done - forked).count() ;
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now() ;
+    std::vector<std::thread> pool ;
+    for(unsigned t = 0 ; t < threads ; t++)
+        pool.emplace_back(worker) ;
+    for(std::thread& thread : pool)
+        thread.join() ;
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() ;
+
+    battlefield.packRecords(after) ;
+    bool untouched = before.size() == after.size() && std::memcmp(before.data(), after.data(), before.size() * sizeof(RobotRecord)) == 0 ;
+
+    std::cout << forks << " forks of " << battlefield.getRobots().size() << " robots on " << threads << " threads, "
+              << depth << " steps each\n"
+              << "fork: " << (forks ? forkNs / forks : 0) << " ns, step: " << (stepsRun ? advanceNs / stepsRun : 0) << " ns, "
+              << (elapsed ? forks * 1000000ll / elapsed : 0) << " forks/s, original " << (untouched ? "untouched" : "CHANGED") << "\n" ;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "Common.h"
+
+void benchmarkRobotModels(int rounds) ;                                  //--bench-models
+void benchmarkForks(Battlefield& battlefield, int forks, int depth) ;   //--bench-forks, on the loaded scenario
@@ -0,0 +1,69 @@
+#include "Bitboard.h"
+
+void Bitboard::reset(int c, int r) {
+    cols = c ;
+    rows = r ;
+    size_t cells = size_t(c) * r ;
+    byRow.assign((cells + 63) / 64, 0) ;
+    byColumn.assign((cells + 63) / 64, 0) ;
+    counts.assign(cells, 0) ;
+}
+
+void Bitboard::add(int x, int y) {
+    if(x < 0 || y < 0 || x >= cols || y >= rows)
+        return ;
+    if(counts[size_t(y) * cols + x]++ == 0) {
+        flip(byRow, size_t(y) * cols + x) ;
+        flip(byColumn, size_t(x) * rows + y) ;
+    }
+}
+
+void Bitboard::remove(int x, int y) {
+    if(x < 0 || y < 0 || x >= cols || y >= rows || counts[size_t(y) * cols + x] == 0)
+        return ;
+    if(--counts[size_t(y) * cols + x] == 0) {
+        flip(byRow, size_t(y) * cols + x) ;
+        flip(byColumn, size_t(x) * rows + y) ;
+    }
+}
+
+bool Bitboard::test(int x, int y) const {
+    if(x < 0 || y < 0 || x >= cols || y >= rows)
+        return false ;
+    size_t bit = size_t(y) * cols + x ;
+    return byRow[bit >> 6] >> (bit & 63) & 1 ;
+}
+
+int Bitboard::countSpan(const std::vector<uint64_t>& bits, size_t begin, size_t end) {
+    int count = 0 ;
+    while(begin < end) {                           //a row or column span covers one or two words
+        size_t word = begin >> 6 ;
+        size_t last = std::min(end, (word + 1) << 6) ;
+        uint64_t mask = ~uint64_t(0) << (begin & 63) ;
+        if(last & 63)
+            mask &= ~(~uint64_t(0) << (last & 63)) ;
+        count += __builtin_popcountll(bits[word] & mask) ;
+        begin = last ;
+    }
+    return count ;
+}
+
+int Bitboard::countRow(int y, int x0, int x1) const {
+    x0 = std::max(x0, 0) ;
+    x1 = std::min(x1, cols - 1) ;
+    if(y < 0 || y >= rows || x0 > x1)
+        return 0 ;
+    return countSpan(byRow, size_t(y) * cols + x0, size_t(y) * cols + x1 + 1) ;
+}
+
+int Bitboard::countColumn(int x, int y0, int y1) const {
+    y0 = std::max(y0, 0) ;
+    y1 = std::min(y1, rows - 1) ;
+    if(x < 0 || x >= cols || y0 > y1)
+        return 0 ;
+    return countSpan(byColumn, size_t(x) * rows + y0, size_t(x) * rows + y1 + 1) ;
+}
+
+int Bitboard::countAround(int x, int y) const {
+    return countRow(y - 1, x - 1, x + 1) + countRow(y, x - 1, x + 1) + countRow(y + 1, x - 1, x + 1) ;
+}
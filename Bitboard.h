@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Common.h"
+
+/*bitboard of the cells robots stand on : one bit per cell in row major order, a column major copy so vertical lines
+are contiguous as well, and a count per cell because robots can end up sharing one (a juggernaut's charge stops
+anywhere). like the spatial index it holds the whole roster, dead robots included, so a set bit only means "look
+closer" while a clear bit proves nobody alive is there. looks, shots and charges use it to skip roster scans*/
+class Bitboard {
+public:
+    void reset(int cols, int rows) ;                //0 x 0 turns it off
+    bool isActive() const { return cols > 0 ; }
+    void add(int x, int y) ;
+    void remove(int x, int y) ;
+    bool test(int x, int y) const ;                 //false outside the board
+    int robotsOn(int x, int y) const { return test(x, y) ? counts[size_t(y) * cols + x] : 0 ; }
+    int countRow(int y, int x0, int x1) const ;     //occupied cells of row y in [x0, x1], clipped to the board
+    int countColumn(int x, int y0, int y1) const ;
+    int countAround(int x, int y) const ;           //3 x 3 block centred on (x, y)
+
+private:
+    int cols = 0, rows = 0 ;
+    std::vector<uint64_t> byRow, byColumn ;
+    std::vector<uint16_t> counts ;
+
+    static int countSpan(const std::vector<uint64_t>& bits, size_t begin, size_t end) ;    //set bits in [begin, end)
+    static void flip(std::vector<uint64_t>& bits, size_t bit) { bits[bit >> 6] ^= uint64_t(1) << (bit & 63) ; }
+};
@@ -0,0 +1,41 @@
+#include "BoardFormatter.h"
+
+void BoardFormatter::begin(int r, int c, const Terrain* terrain) {
+    static const char* const marks[] = {"+___", "+###", "+%%%", "+~~~"} ;
+    rows = r ;
+    cols = c ;
+    cells.resize(size_t(r) * c) ;                   //cells are short strings, reassigning them in place never allocates
+    bool marked = terrain && !terrain->empty() ;
+    for (int y = 0; y < rows; ++y)
+        for (int x = 0; x < cols; ++x)
+            cells[size_t(y) * cols + x] = marked ? marks[terrain->at(x, y)] : "+___" ;
+}
+
+void BoardFormatter::place(int x, int y, std::string_view name) {
+    if(x < 0 || y < 0 || x >= cols || y >= rows)
+        return ;
+    std::string& cell = cells[size_t(y) * cols + x] ;
+    cell = "+" ;
+    cell.append(name.substr(0, 3)) ;
+}
+
+static void appendLabel(std::string& out, int index) {           //"+_7_" or "+_12"
+    char digits[16] ;
+    out += "+_" ;
+    out.append(digits, std::to_chars(digits, digits + sizeof(digits), index).ptr) ;
+    if(index < 10)
+        out += "_" ;
+}
+
+void BoardFormatter::write(std::string& out) const {
+    out += "+___" ;
+    for (int x = 0; x < cols; ++x)
+        appendLabel(out, x) ;
+    out += "\n" ;
+    for (int y = 0; y < rows; ++y) {
+        appendLabel(out, y) ;
+        for (int x = 0; x < cols; ++x)
+            out += cells[size_t(y) * cols + x] ;
+        out += "\n" ;
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Terrain.h"
+
+/*board text of display(), shared with the render thread and the replay / shared memory viewers. begin() lays out an
+empty board (terrain marks when given), place() puts "+" and the first three letters of a name on a cell, later
+robots cover earlier ones. cells are kept between boards so formatting the next one does not allocate*/
+class BoardFormatter {
+    int rows = 0, cols = 0 ;
+    std::vector<std::string> cells ;                //row major
+
+public:
+    void begin(int r, int c, const Terrain* terrain = nullptr) ;
+    void place(int x, int y, std::string_view name) ;   //off board cells are ignored
+    void write(std::string& out) const ;                //appends
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <string_view>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cassert>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+#include <tuple>
+#include <array>
+#include <utility>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <sys/socket.h>
+#include <sys/un.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+const int MAX_ROWS = 80;
+const int MAX_COLS = 50;
+const int BITBOARD_MAX_CELLS = 1 << 16 ;            //boards up to this many cells (256 x 256) get the bitboard
+const int SCENARIO_MAX_SIDE = 4096 ;                //largest rows or cols a scenario may ask for
+const int SCENARIO_MAX_ROBOTS = 1 << 20 ;           //largest "robots:" count
+
+class Robot;
+class GenericRobot;
+class RobotSlots;
+class Battlefield;
+class Logger;
+
+//every concrete robot class, in declaration order. used for the kind enum and anything generated per class
+#define ROBOT_KINDS(X) \
+    X(GenericRobot) X(HideBot) X(JumpBot) X(JuggernautBot) \
+    X(TrueDamageBot) X(LifestealBot) X(LongshotBot) X(ThirtyshotBot) \
+    X(SemiautoBot) X(ScoutBot) X(TrackerBot) X(HideLongshotBot) \
+    X(HideSemiautoBot) X(HideThirtyshotBot) X(HideTrueDamageBot) X(HideLifestealBot) \
+    X(JumpLongshotBot) X(JumpSemiautoBot) X(JumpThirtyshotBot) X(JumpTrueDamageBot) \
+    X(JumpLifestealBot) X(JuggernautLongshotBot) X(JuggernautSemiautoBot) X(JuggernautThirtyshotBot) \
+    X(JuggernautTrueDamageBot) X(JuggernautLifestealBot) X(HideLongshotScoutBot) X(HideLongshotTrackerBot) \
+    X(HideSemiautoScoutBot) X(HideSemiautoTrackerBot) X(HideThirtyshotScoutBot) X(HideThirtyshotTrackerBot) \
+    X(HideTrueDamageScoutBot) X(HideTrueDamageTrackerBot) X(HideLifestealScoutBot) X(HideLifestealTrackerBot) \
+    X(JumpLongshotScoutBot) X(JumpLongshotTrackerBot) X(JumpSemiautoScoutBot) X(JumpSemiautoTrackerBot) \
+    X(JumpThirtyshotScoutBot) X(JumpThirtyshotTrackerBot) X(JumpTrueDamageScoutBot) X(JumpTrueDamageTrackerBot) \
+    X(JumpLifestealScoutBot) X(JumpLifestealTrackerBot) X(JuggernautLongshotScoutBot) X(JuggernautLongshotTrackerBot) \
+    X(JuggernautSemiautoScoutBot) X(JuggernautSemiautoTrackerBot) X(JuggernautThirtyshotScoutBot) X(JuggernautThirtyshotTrackerBot) \
+    X(JuggernautTrueDamageScoutBot) X(JuggernautTrueDamageTrackerBot) X(JuggernautLifestealScoutBot) X(JuggernautLifestealTrackerBot)
+
+enum class RobotKind : uint8_t {
+#define X(kind) kind,
+    ROBOT_KINDS(X)
+#undef X
+    COUNT
+};
+
+const std::string& robotKindName(RobotKind kind) ;
+RobotKind robotKindFromName(std::string_view name) ;       //unknown names map to GenericRobot
+
+class NameTable {                                   //process wide interned robot names, ids never change or get reused
+    static const uint32_t CHUNK_BITS = 12 ;
+    static const uint32_t CHUNK_SIZE = 1u << CHUNK_BITS ;
+    static const uint32_t MAX_CHUNKS = 1u << 12 ;
+    static const uint32_t FULL_ID = MAX_CHUNKS * CHUNK_SIZE - 1 ;  //"?", given to every name once the table is full
+
+    static std::atomic<std::string*> chunks[MAX_CHUNKS] ;   //lock free lookups, interning takes the mutex
+    static std::unordered_map<std::string_view, uint32_t> ids ;
+    static uint32_t count ;
+    static std::mutex mutex ;
+
+public:
+    static uint32_t intern(std::string_view name) ;
+    static const std::string& name(uint32_t id) {
+        return chunks[id >> CHUNK_BITS].load(std::memory_order_acquire)[id & (CHUNK_SIZE - 1)] ;
+    }
+};
+
+//snapshot of one robot's state for replays, shared memory and the render thread, 20 bytes.
+//the simulation itself still iterates Robot objects, packRecords copies them out once per step.
+//positions are limited to 16 bits
+struct RobotRecord {
+    enum Flags : uint8_t { ALIVE = 1, UPGRADE_FIRST = 2, UPGRADE_SECOND = 4, UPGRADE_THIRD = 8 } ;
+
+    uint32_t nameId ;
+    int16_t x, y ;
+    RobotKind kind ;
+    uint8_t flags ;
+    int8_t lives ;
+    int8_t revivals ;
+    int16_t shells ;
+    int16_t upgradePoints ;
+    uint32_t slot ;                                 //roster slot (RobotHandle::index), unique among the robots on the roster
+};
+static_assert(sizeof(RobotRecord) <= 32, "RobotRecord must stay within half a cache line") ;
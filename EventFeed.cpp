@@ -0,0 +1,82 @@
+#include "EventFeed.h"
+
+EventFeed::EventFeed(size_t capacityPow2) {
+    size_t capacity = 1 ;
+    while(capacity < capacityPow2)
+        capacity <<= 1 ;
+    slots.reset(new Slot[capacity]) ;
+    mask = capacity - 1 ;
+}
+
+void EventFeed::publish(GameEventType type, uint32_t step, uint32_t nameId, int x, int y, RobotKind kind) {
+    uint64_t n = head.load(std::memory_order_relaxed) ;
+    Slot& slot = slots[n & mask] ;
+
+    slot.stamp.store(2 * n + 1, std::memory_order_relaxed) ;
+    std::atomic_thread_fence(std::memory_order_release) ;          //readers see the odd stamp before new words
+    slot.words[0].store(uint64_t(step) << 32 | nameId, std::memory_order_relaxed) ;
+    slot.words[1].store(uint64_t(uint16_t(x)) | uint64_t(uint16_t(y)) << 16 | uint64_t(type) << 32 | uint64_t(kind) << 40, std::memory_order_relaxed) ;
+    slot.stamp.store(2 * n + 2, std::memory_order_release) ;
+    head.store(n + 1, std::memory_order_release) ;
+}
+
+size_t EventFeed::poll(Cursor& cursor, GameEvent* out, size_t max) const {
+    size_t got = 0 ;
+    while(got < max) {
+        uint64_t end = head.load(std::memory_order_acquire) ;
+        if(cursor.next >= end)
+            break ;
+        if(end - cursor.next > mask + 1) {                         //lapped, the oldest events are gone
+            cursor.lost += end - (mask + 1) - cursor.next ;
+            cursor.next = end - (mask + 1) ;
+        }
+
+        const Slot& slot = slots[cursor.next & mask] ;
+        uint64_t before = slot.stamp.load(std::memory_order_acquire) ;
+        uint64_t first = slot.words[0].load(std::memory_order_relaxed) ;
+        uint64_t second = slot.words[1].load(std::memory_order_relaxed) ;
+        std::atomic_thread_fence(std::memory_order_acquire) ;
+        uint64_t after = slot.stamp.load(std::memory_order_relaxed) ;
+
+        if(before != 2 * cursor.next + 2 || after != before) {     //overwritten while we looked
+            cursor.lost++ ;
+            cursor.next++ ;
+            continue ;
+        }
+
+        GameEvent& event = out[got++] ;
+        event.sequence = cursor.next++ ;
+        event.step = uint32_t(first >> 32) ;
+        event.nameId = uint32_t(first) ;
+        event.x = int16_t(second & 0xFFFF) ;
+        event.y = int16_t(second >> 16 & 0xFFFF) ;
+        event.type = GameEventType(second >> 32 & 0xFF) ;
+        event.kind = RobotKind(second >> 40 & 0xFF) ;
+    }
+    return got ;
+}
+
+void spectateEvents(const EventFeed& feed, EventFeed::Cursor cursor, std::atomic<bool>& finished, int delayMicros) {   //sample observer, summary on stderr
+    static const char* const names[EVENT_COUNT] = {"moves", "shots", "hits", "deaths", "revives", "upgrades"} ;
+    GameEvent batch[256] ;
+    uint64_t counts[EVENT_COUNT] = {} ;
+
+    while(true) {
+        bool last = finished.load(std::memory_order_acquire) ;     //drain once more after the match ends
+        size_t got ;
+        while((got = feed.poll(cursor, batch, 256)) > 0) {
+            for(size_t i = 0 ; i < got ; i++)
+                counts[batch[i].type]++ ;
+            if(delayMicros > 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(delayMicros)) ;
+        }
+        if(last)
+            break ;
+        std::this_thread::sleep_for(std::chrono::microseconds(std::max(delayMicros, 200))) ;
+    }
+
+    std::cerr << "Spectator saw" ;
+    for(int i = 0 ; i < EVENT_COUNT ; i++)
+        std::cerr << " " << names[i] << "=" << counts[i] ;
+    std::cerr << " lost=" << cursor.lost << " of " << feed.published() << "\n" ;
+}
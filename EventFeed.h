@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Common.h"
+
+enum GameEventType : uint8_t { EVENT_MOVE, EVENT_SHOT, EVENT_HIT, EVENT_DEATH, EVENT_REVIVE, EVENT_UPGRADE, EVENT_COUNT } ;
+
+struct GameEvent {
+    uint64_t sequence ;
+    uint32_t step ;
+    uint32_t nameId ;                               //robot the event is about
+    int16_t x, y ;                                  //its position afterwards
+    GameEventType type ;
+    RobotKind kind ;
+};
+
+/*spectator feed : a broadcast ring written by the step loop, read by any number of observer threads. publish()
+never waits; every slot is a small seqlock, so a reader that falls a whole ring behind (or gets lapped while
+copying a slot) skips ahead and adds what it missed to its cursor's lost count*/
+class EventFeed {
+public:
+    struct Cursor {
+        uint64_t next = 0 ;
+        uint64_t lost = 0 ;
+    };
+
+    explicit EventFeed(size_t capacityPow2 = 1 << 14) ;
+    void publish(GameEventType type, uint32_t step, uint32_t nameId, int x, int y, RobotKind kind) ;    //producer only
+    Cursor subscribe() const { return Cursor{head.load(std::memory_order_acquire), 0} ; }
+    size_t poll(Cursor& cursor, GameEvent* out, size_t max) const ;            //events since the cursor, oldest first
+    uint64_t published() const { return head.load(std::memory_order_acquire) ; }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> stamp {0} ;           //2n+1 while event n is written, 2n+2 once it is complete
+        std::atomic<uint64_t> words[2] ;
+    };
+
+    std::unique_ptr<Slot[]> slots ;
+    size_t mask ;
+    alignas(64) std::atomic<uint64_t> head {0} ;    //events published so far
+};
+
+void spectateEvents(const EventFeed& feed, EventFeed::Cursor cursor, std::atomic<bool>& finished, int delayMicros) ;   //--spectate
@@ -0,0 +1,64 @@
+#include "FlowField.h"
+
+void FlowField::reset(int c, int r) {
+    cols = c ;
+    rows = r ;
+    size_t cells = size_t(cols) * rows ;
+    blocked.assign(cells, false) ;
+    firstDistance.assign(cells, UNREACHED) ;
+    secondDistance.assign(cells, UNREACHED) ;
+    firstSource.assign(cells, 0) ;
+    secondSource.assign(cells, 0) ;
+    sources.clear() ;
+}
+
+void FlowField::setBlocked(int x, int y, bool state) {
+    if(x >= 0 && y >= 0 && x < cols && y < rows)
+        blocked[size_t(y) * cols + x] = state ;
+}
+
+void FlowField::build() {
+    std::fill(firstDistance.begin(), firstDistance.end(), UNREACHED) ;
+    std::fill(secondDistance.begin(), secondDistance.end(), UNREACHED) ;
+    queue.clear() ;
+
+    //a cell takes a source only if it is not one of its two already, so each cell is queued at most twice
+    auto offer = [this](int cell, uint32_t id, int distance) {
+        if(firstDistance[cell] == UNREACHED) {
+            firstDistance[cell] = distance ;
+            firstSource[cell] = id ;
+        }
+        else if(secondDistance[cell] == UNREACHED && firstSource[cell] != id) {
+            secondDistance[cell] = distance ;
+            secondSource[cell] = id ;
+        }
+        else {
+            return ;
+        }
+        queue.push_back({cell, id, distance}) ;
+    };
+
+    for(const Source& source : sources) {
+        if(source.cell >= 0 && size_t(source.cell) < blocked.size() && !blocked[source.cell])
+            offer(source.cell, source.id, 0) ;
+    }
+
+    for(size_t head = 0 ; head < queue.size() ; head++) {         //FIFO, so distances leave in order
+        Entry entry = queue[head] ;
+        int x = entry.cell % cols, y = entry.cell / cols ;
+        for(int dy = -1 ; dy <= 1 ; dy++) {
+            for(int dx = -1 ; dx <= 1 ; dx++) {
+                int nx = x + dx, ny = y + dy ;
+                if((dx || dy) && nx >= 0 && ny >= 0 && nx < cols && ny < rows && !blocked[ny * cols + nx])
+                    offer(ny * cols + nx, entry.id, entry.distance + 1) ;
+            }
+        }
+    }
+}
+
+int FlowField::distance(int x, int y, uint32_t exclude) const {
+    if(x < 0 || y < 0 || x >= cols || y >= rows)
+        return UNREACHED ;
+    size_t cell = size_t(y) * cols + x ;
+    return firstSource[cell] != exclude || firstDistance[cell] == UNREACHED ? firstDistance[cell] : secondDistance[cell] ;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Common.h"
+
+/*shared distance field for goal directed movement. one multi-source BFS (8-neighbour steps, blocked cells
+excluded) from every source, keeping the two closest distinct sources per cell so a robot that is itself a
+source can read the distance to the nearest other one. built once per step, a move is then a look at 8 cells*/
+class FlowField {
+public:
+    static constexpr int UNREACHED = INT32_MAX ;
+
+    void reset(int cols, int rows) ;
+    void setBlocked(int x, int y, bool state) ;
+    bool isBlocked(int x, int y) const { return blocked[size_t(y) * cols + x] ; }
+    void clearSources() { sources.clear() ; }
+    void addSource(int x, int y, uint32_t id) {
+        assert(x >= 0 && x < cols && y >= 0 && y < rows) ;     //off board cells would wrap into the next row
+        sources.push_back({y * cols + x, id}) ;
+    }
+    void build() ;
+    int distance(int x, int y, uint32_t exclude) const ;       //to the nearest source other than exclude
+
+private:
+    struct Source { int cell ; uint32_t id ; } ;
+    struct Entry { int cell ; uint32_t id ; int distance ; } ;
+
+    int cols = 0, rows = 0 ;
+    std::vector<bool> blocked ;
+    std::vector<Source> sources ;
+    std::vector<int> firstDistance, secondDistance ;
+    std::vector<uint32_t> firstSource, secondSource ;
+    std::vector<Entry> queue ;
+};
@@ -0,0 +1,271 @@
+#include "MatchService.h"
+#include "Battlefield.h"
+
+void MatchService::Connection::send(const std::string& text) {
+    std::lock_guard<std::mutex> guard(writeLock) ;
+    size_t sent = 0 ;
+    while(sent < text.size()) {
+        ssize_t wrote = ::send(fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL) ;
+        if(wrote <= 0)
+            return ;                                       //client went away, drop the result
+        sent += wrote ;
+    }
+}
+
+void MatchService::stop() {
+    stopping = true ;
+    if(listenFd >= 0)
+        shutdown(listenFd, SHUT_RDWR) ;                    //wakes accept()
+    { std::lock_guard<std::mutex> guard(sleepLock) ; }
+    wake.notify_all() ;
+}
+
+void MatchService::submit(Job job) {
+    WorkerQueue& queue = *queues[nextQueue++ % queues.size()] ;
+    {
+        std::lock_guard<std::mutex> guard(queue.lock) ;
+        queue.jobs.push_back(std::move(job)) ;
+    }
+    queued++ ;
+    { std::lock_guard<std::mutex> guard(sleepLock) ; }     //a worker between its check and wait() sees the count
+    wake.notify_one() ;
+}
+
+bool MatchService::take(size_t self, Job& job) {
+    for(size_t i = 0 ; i < queues.size() ; i++) {
+        WorkerQueue& queue = *queues[(self + i) % queues.size()] ;
+        std::lock_guard<std::mutex> guard(queue.lock) ;
+        if(queue.jobs.empty())
+            continue ;
+        if(i == 0) {
+            job = std::move(queue.jobs.front()) ;
+            queue.jobs.pop_front() ;
+        }
+        else {
+            job = std::move(queue.jobs.back()) ;
+            queue.jobs.pop_back() ;
+        }
+        queued-- ;
+        return true ;
+    }
+    return false ;
+}
+
+void MatchService::workerLoop(size_t self) {
+    Battlefield battlefield(MAX_ROWS, MAX_COLS, new Logger("")) ;   //reused for every match this worker runs
+    battlefield.getLogger()->setEnabled(false) ;
+    battlefield.setOwnRandom(true) ;
+    battlefield.setKindStats(true) ;
+
+    Job job ;
+    while(true) {
+        if(take(self, job)) {
+            std::string reply ;
+            try {
+                reply = runJob(battlefield, job) ;
+            }
+            catch(const std::exception& error) {                    //a bad scenario fails its own job, not the daemon
+                reply = "ERROR " + std::to_string(job.id) + " " + error.what() + "\n" ;
+            }
+            job.connection->send(reply) ;
+            job = Job() ;
+            continue ;
+        }
+        std::unique_lock<std::mutex> guard(sleepLock) ;
+        if(stopping && queued == 0)
+            return ;
+        wake.wait(guard, [this] { return queued > 0 || stopping ; }) ;
+    }
+}
+
+std::string MatchService::runJob(Battlefield& battlefield, const Job& job) {
+    auto start = std::chrono::steady_clock::now() ;
+    std::string id = std::to_string(job.id) ;
+
+    battlefield.clear() ;
+    battlefield.seedRandom(job.seed) ;
+    if(!battlefield.loadFromText(job.scenario))
+        return "ERROR " + id + " malformed scenario\n" ;
+    if(battlefield.getRobots().empty())
+        return "ERROR " + id + " scenario has no robots\n" ;
+    battlefield.runSimulation() ;
+
+    const size_t KINDS = size_t(RobotKind::COUNT) ;
+    std::array<int, size_t(RobotKind::COUNT)> aliveByKind {} ;
+    Robot* winner = nullptr ;
+    int alive = 0 ;
+    for(Robot* robot : battlefield.getRobots()) {
+        if(robot->isAlive()) {
+            alive++ ;
+            winner = robot ;
+            aliveByKind[size_t(robot->getKind())]++ ;
+        }
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() ;
+    std::string out = "RESULT " + id + " winner=" + (alive == 1 ? winner->getName() : std::string("none"))
+                      + " steps=" + std::to_string(battlefield.getStepsRun()) + " alive=" + std::to_string(alive)
+                      + " ms=" + std::to_string(ms) + "\n" ;
+
+    static const char* const actionNames[ACTION_COUNT] = {"moves", "shots", "hits", "looks", "upgrades", "revives"} ;
+    for(size_t k = 0 ; k < KINDS ; k++) {
+        const auto& actions = battlefield.getKindActions(RobotKind(k)) ;
+        bool seen = aliveByKind[k] > 0 ;
+        for(uint32_t count : actions)
+            seen = seen || count > 0 ;
+        if(!seen)
+            continue ;
+        out += "TYPE " + id + " " + robotKindName(RobotKind(k)) + " alive=" + std::to_string(aliveByKind[k]) ;
+        for(int a = 0 ; a < ACTION_COUNT ; a++)
+            out += std::string(" ") + actionNames[a] + "=" + std::to_string(actions[a]) ;
+        out += "\n" ;
+    }
+    return out + "END " + id + "\n" ;
+}
+
+void MatchService::readConnection(std::shared_ptr<Connection> connection) {
+    std::string pending ;
+    size_t begin = 0 ;
+    char chunk[1 << 16] ;
+    Job job ;
+    bool inJob = false ;
+    const char* rejected = nullptr ;                //why the job being read will not run, reported at its END
+
+    while(true) {
+        size_t newline = pending.find('\n', begin) ;
+        if(newline == std::string::npos) {
+            pending.erase(0, begin) ;
+            begin = 0 ;
+            if(pending.size() > MAX_JOB_BYTES) {
+                connection->send("ERROR - line longer than " + std::to_string(MAX_JOB_BYTES) + " bytes\n") ;
+                return ;
+            }
+            ssize_t got = recv(connection->fd, chunk, sizeof(chunk), 0) ;
+            if(got <= 0)
+                return ;
+            pending.append(chunk, got) ;
+            continue ;
+        }
+
+        std::string_view line(pending.data() + begin, newline - begin) ;
+        begin = newline + 1 ;
+        if(!line.empty() && line.back() == '\r')
+            line.remove_suffix(1) ;
+
+        if(inJob) {
+            if(line == "END") {
+                if(rejected)
+                    connection->send("ERROR " + std::to_string(job.id) + " " + rejected + "\n") ;
+                else {
+                    job.connection = connection ;
+                    submit(std::move(job)) ;
+                }
+                job = Job() ;
+                inJob = false ;
+                rejected = nullptr ;
+            }
+            else if(rejected) {
+                //skip to END
+            }
+            else if(job.scenario.size() + line.size() + 1 > MAX_JOB_BYTES) {
+                rejected = "scenario too large" ;
+                job.scenario = std::string() ;
+            }
+            else {
+                job.scenario.append(line) ;
+                job.scenario += '\n' ;
+            }
+        }
+        else if(line.substr(0, 4) == "JOB ") {
+            std::string header(line.substr(4)) ;
+            char* end ;
+            errno = 0 ;
+            job.id = std::strtoull(header.c_str(), &end, 10) ;
+            if(end == header.c_str() || errno || (*end && *end != ' '))
+                rejected = "malformed JOB header" ;
+            else if(*end) {
+                char* seedEnd ;
+                unsigned long seed = std::strtoul(end, &seedEnd, 10) ;
+                if(seedEnd == end || *seedEnd || errno || seed > UINT32_MAX)
+                    rejected = "malformed seed" ;
+                job.seed = unsigned(seed) ;
+            }
+            else
+                job.seed = unsigned(job.id) ;                       //default seed is the job id
+            inJob = true ;
+        }
+        else if(line == "QUIT") {
+            stop() ;
+            return ;
+        }
+        else if(!line.empty()) {
+            connection->send("ERROR - unknown command " + std::string(line) + "\n") ;
+        }
+    }
+}
+
+int MatchService::run(int workers) {
+    sockaddr_un address {} ;
+    address.sun_family = AF_UNIX ;
+    if(socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Invalid socket path " << socketPath << "\n" ;
+        return 1 ;
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1) ;
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0) ;
+    unlink(socketPath.c_str()) ;
+    if(listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listenFd, 64) != 0) {
+        std::cerr << "Cannot listen on " << socketPath << "\n" ;
+        return 1 ;
+    }
+
+    workers = std::max(1, workers) ;
+    for(int i = 0 ; i < workers ; i++)
+        queues.push_back(std::make_unique<WorkerQueue>()) ;
+    std::vector<std::thread> pool ;
+    for(int i = 0 ; i < workers ; i++)
+        pool.emplace_back(&MatchService::workerLoop, this, size_t(i)) ;
+    std::cout << "Serving matches on " << socketPath << " with " << workers << " workers\n" << std::flush ;
+
+    while(!stopping) {
+        int fd = accept(listenFd, nullptr, nullptr) ;
+        if(fd < 0) {
+            if(errno == EINTR)
+                continue ;
+            break ;
+        }
+
+        for(auto it = readers.begin() ; it != readers.end() ; ) {       //reap finished readers
+            if(*it->done) {
+                it->thread.join() ;
+                it = readers.erase(it) ;
+            }
+            else {
+                ++it ;
+            }
+        }
+
+        auto connection = std::make_shared<Connection>(fd) ;
+        auto done = std::make_shared<std::atomic<bool>>(false) ;
+        std::thread thread([this, connection, done] {
+            readConnection(connection) ;
+            *done = true ;
+        }) ;
+        readers.push_back({std::move(thread), connection, done}) ;
+    }
+
+    stop() ;
+    for(Reader& reader : readers) {                       //stop reading, queued jobs still get their results
+        if(auto connection = reader.connection.lock())
+            shutdown(connection->fd, SHUT_RD) ;
+        reader.thread.join() ;
+    }
+    readers.clear() ;
+    for(std::thread& worker : pool)
+        worker.join() ;
+
+    close(listenFd) ;
+    unlink(socketPath.c_str()) ;
+    return 0 ;
+}
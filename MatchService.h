@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Common.h"
+
+/*daemon mode. clients send scenario jobs over a UNIX socket, each worker thread keeps one warm Battlefield and
+its own job deque, idle workers steal from the others. results go back on the job's connection as they finish :
+    JOB <id> [seed]        ->   RESULT <id> winner=<name|none> steps=<n> alive=<n> ms=<t>
+    <scenario lines>            TYPE <id> <kind> alive=<n> moves=<n> shots=<n> hits=<n> looks=<n> upgrades=<n> revives=<n>
+    END                         END <id>
+    QUIT                   stops the service once the queued jobs are done*/
+class MatchService {
+public:
+    explicit MatchService(const std::string& socketPath) : socketPath(socketPath) {}
+    int run(int workers) ;
+
+    static constexpr size_t MAX_JOB_BYTES = 16 << 20 ;     //scenario text of one job, and the longest line read
+
+private:
+    struct Connection {
+        int fd ;
+        std::mutex writeLock ;
+        explicit Connection(int descriptor) : fd(descriptor) {}
+        ~Connection() { close(fd) ; }
+        void send(const std::string& text) ;
+    };
+    struct Job {
+        uint64_t id = 0 ;
+        unsigned seed = 0 ;
+        std::string scenario ;
+        std::shared_ptr<Connection> connection ;
+    };
+    struct WorkerQueue {
+        std::mutex lock ;
+        std::deque<Job> jobs ;
+    };
+    struct Reader {
+        std::thread thread ;
+        std::weak_ptr<Connection> connection ;
+        std::shared_ptr<std::atomic<bool>> done ;
+    };
+
+    std::string socketPath ;
+    int listenFd = -1 ;
+    std::vector<std::unique_ptr<WorkerQueue>> queues ;
+    std::atomic<size_t> nextQueue {0} ;
+    std::atomic<size_t> queued {0} ;
+    std::atomic<bool> stopping {false} ;
+    std::mutex sleepLock ;
+    std::condition_variable wake ;
+    std::vector<Reader> readers ;
+
+    void stop() ;
+    void submit(Job job) ;
+    bool take(size_t self, Job& job) ;              //oldest of our own jobs, else the newest of someone else's
+    void workerLoop(size_t self) ;
+    void readConnection(std::shared_ptr<Connection> connection) ;
+    static std::string runJob(Battlefield& battlefield, const Job& job) ;
+};
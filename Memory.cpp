@@ -0,0 +1,78 @@
+#include "Memory.h"
+
+StepArena::StepArena(size_t firstBlock) {
+    blocks.emplace_back(new char[firstBlock]) ;
+    sizes.push_back(firstBlock) ;
+}
+
+void* StepArena::do_allocate(size_t bytes, size_t alignment) {
+    while(true) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(blocks[current].get()) ;
+        size_t start = ((base + used + alignment - 1) & ~uintptr_t(alignment - 1)) - base ;
+        if(start + bytes <= sizes[current]) {
+            used = start + bytes ;
+            return blocks[current].get() + start ;
+        }
+        if(++current == blocks.size()) {          //spill : a new block, at least double the last one
+            size_t size = std::max(sizes.back() * 2, bytes + alignment) ;
+            blocks.emplace_back(new char[size]) ;
+            sizes.push_back(size) ;
+        }
+        used = 0 ;
+    }
+}
+
+void StepArena::reset() {
+    if(current > 0) {                             //spilled this step, next time one block holds it all
+        size_t total = capacity() ;
+        blocks.clear() ;
+        sizes.clear() ;
+        blocks.emplace_back(new char[total]) ;
+        sizes.push_back(total) ;
+    }
+    current = 0 ;
+    used = 0 ;
+}
+
+size_t StepArena::capacity() const {
+    size_t total = 0 ;
+    for(size_t size : sizes)
+        total += size ;
+    return total ;
+}
+
+thread_local RobotPool::FreeLists RobotPool::lists ;
+
+void* RobotPool::allocate(size_t bytes) {
+    size_t index = (bytes + GRAIN - 1) / GRAIN ;
+    if(index >= CLASSES)
+        return ::operator new(bytes) ;
+    if(Block* block = lists.heads[index]) {
+        lists.heads[index] = block->next ;
+        return block ;
+    }
+    return ::operator new(index * GRAIN) ;
+}
+
+void RobotPool::release(void* block, size_t bytes) {
+    if(!block)
+        return ;
+    size_t index = (bytes + GRAIN - 1) / GRAIN ;
+    if(index >= CLASSES) {
+        ::operator delete(block) ;
+        return ;
+    }
+    Block* freed = static_cast<Block*>(block) ;
+    freed->next = lists.heads[index] ;
+    lists.heads[index] = freed ;
+}
+
+RobotPool::FreeLists::~FreeLists() {
+    for(Block*& head : heads) {
+        while(head) {
+            Block* next = head->next ;
+            ::operator delete(head) ;
+            head = next ;
+        }
+    }
+}
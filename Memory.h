@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Common.h"
+
+/*bump allocator for memory that only lives during one step (look areas, upgrade candidates ...). reset() rewinds
+without freeing, and a step that spilled into extra blocks gets one block of the combined size next time, so once
+the largest step has been seen the arena stops calling the global allocator. deallocate does nothing*/
+class StepArena : public std::pmr::memory_resource {
+    std::vector<std::unique_ptr<char[]>> blocks ;
+    std::vector<size_t> sizes ;
+    size_t current = 0 ;                            //block being bumped
+    size_t used = 0 ;                               //bytes taken from it
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override ;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other ; }
+
+public:
+    explicit StepArena(size_t firstBlock = 64 * 1024) ;
+    void reset() ;
+    size_t capacity() const ;
+};
+
+/*recycled memory for robot objects. revivals, upgrades and forks delete one robot and build another every step, so
+freed blocks go on a per thread free list (64 byte size classes) and the next robot of that class takes one back.
+the lists only hold what was freed, they are returned to the global allocator when the thread exits*/
+class RobotPool {
+public:
+    static void* allocate(size_t bytes) ;
+    static void release(void* block, size_t bytes) ;
+
+private:
+    static const size_t GRAIN = 64 ;
+    static const size_t CLASSES = 32 ;              //blocks up to 2 KB, anything bigger is not pooled
+    struct Block { Block* next ; } ;
+    struct FreeLists {
+        Block* heads[CLASSES] = {} ;
+        ~FreeLists() ;
+    };
+    static thread_local FreeLists lists ;
+};
@@ -0,0 +1,266 @@
+#include "Metrics.h"
+
+int LatencyHistogram::bucketOf(uint64_t value) {
+    if(value < SUB_BUCKETS)
+        return value ;
+    int msb = 63 - __builtin_clzll(value) ;
+    return (msb - 3) * SUB_BUCKETS + ((value >> (msb - 4)) & (SUB_BUCKETS - 1)) ;
+}
+
+uint64_t LatencyHistogram::valueOf(int bucket) {
+    if(bucket < SUB_BUCKETS)
+        return bucket ;
+    int msb = bucket / SUB_BUCKETS + 3 ;
+    return uint64_t(SUB_BUCKETS + bucket % SUB_BUCKETS) << (msb - 4) ;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    buckets[bucketOf(value)]++ ;
+    count++ ;
+    total += value ;
+    maximum = std::max(maximum, value) ;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if(count == 0)
+        return 0 ;
+    uint64_t rank = static_cast<uint64_t>(p * (count - 1)) + 1 ;
+    uint64_t seen = 0 ;
+    for(int i = 0 ; i < 64 * SUB_BUCKETS ; i++) {
+        seen += buckets[i] ;
+        if(seen >= rank)
+            return std::min(valueOf(i), maximum) ;
+    }
+    return maximum ;
+}
+
+PerfCounters::PerfCounters() {
+    for(int i = 0 ; i < PERF_EVENT_COUNT ; i++) {
+        fds[i] = -1 ;
+        slots[i] = -1 ;
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for(int i = 0 ; i < PERF_EVENT_COUNT ; i++) {
+        if(fds[i] >= 0)
+            close(fds[i]) ;
+    }
+}
+
+const char* PerfCounters::eventName(PerfEvent event) {
+    static const char* names[PERF_EVENT_COUNT] = {"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"} ;
+    return names[event] ;
+}
+
+bool PerfCounters::open() {
+#ifdef __linux__
+    if(opened > 0)
+        return true ;
+
+    const uint64_t l1dReadMiss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) ;
+    const uint32_t types[PERF_EVENT_COUNT] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE} ;
+    const uint64_t configs[PERF_EVENT_COUNT] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, l1dReadMiss,
+                                                PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES} ;
+    int leader = -1 ;
+
+    for(int i = 0 ; i < PERF_EVENT_COUNT ; i++) {
+        perf_event_attr attr ;
+        std::memset(&attr, 0, sizeof(attr)) ;
+        attr.size = sizeof(attr) ;
+        attr.type = types[i] ;
+        attr.config = configs[i] ;
+        attr.disabled = leader < 0 ;
+        attr.exclude_kernel = 1 ;
+        attr.exclude_hv = 1 ;
+        attr.read_format = PERF_FORMAT_GROUP ;
+
+        fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0) ;
+        if(fds[i] < 0) {
+            if(i == 0)                                  //no cycle counter, nothing else will work either
+                return false ;
+            continue ;                                  //skip events this machine does not have
+        }
+        if(leader < 0)
+            leader = fds[i] ;
+        slots[i] = opened++ ;
+    }
+
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP) ;
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) ;
+    return true ;
+#else
+    return false ;
+#endif
+}
+
+void PerfCounters::read(PerfSample& sample) const {
+    uint64_t buffer[1 + PERF_EVENT_COUNT] = {} ;        //{nr, values...}
+    if(opened == 0 || ::read(fds[0], buffer, sizeof(buffer)) <= 0)
+        return ;
+
+    for(int i = 0 ; i < PERF_EVENT_COUNT ; i++)
+        sample.values[i] = slots[i] >= 0 ? buffer[1 + slots[i]] : 0 ;
+}
+
+const char* StepMetrics::phaseName(StepPhase phase) {
+    static const char* names[PHASE_COUNT] = {"revive", "turns", "graveyard", "upgrade", "display", "graveyard_print", "alive_count", "roster_sort"} ;
+    return names[phase] ;
+}
+
+const char* StepMetrics::actionName(ActionType action) {
+    static const char* names[ACTION_COUNT] = {"moves", "shots", "hits", "looks", "upgrades", "revives"} ;
+    return names[action] ;
+}
+
+void StepMetrics::enable(const std::string& filename, int flushEvery) {
+    enabled = true ;
+    outputFile = filename ;
+    flushInterval = flushEvery ;
+}
+
+void PhaseTimer::start() {
+    if(timed)
+        mark = std::chrono::steady_clock::now() ;
+    if(counted)
+        metrics.readPerf(perfMark) ;
+}
+
+void PhaseTimer::done(StepPhase phase) {
+    if(!timed)
+        return ;
+    if(counted) {
+        metrics.readPerf(perfNow) ;
+        metrics.recordPhasePerf(phase, perfMark, perfNow) ;
+    }
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now() ;
+    metrics.recordPhase(phase, std::chrono::duration_cast<std::chrono::nanoseconds>(now - mark).count()) ;
+    mark = now ;
+    if(counted)
+        metrics.readPerf(perfMark) ;
+}
+
+void StepMetrics::endStep() {
+    stepsRecorded++ ;
+    if(enabled && flushInterval > 0 && stepsRecorded % flushInterval == 0)
+        write() ;
+}
+
+void StepMetrics::writePerfJson(std::ostream& out, const PerfSample& sample) const {
+    out << "{" ;
+    bool first = true ;
+    for(int e = 0 ; e < PERF_EVENT_COUNT ; e++) {
+        if(!counters.hasEvent(PerfEvent(e)))
+            continue ;
+        out << (first ? "" : ", ") << "\"" << PerfCounters::eventName(PerfEvent(e)) << "\": " << sample.values[e] ;
+        first = false ;
+    }
+    out << "}" ;
+}
+
+bool StepMetrics::write() const {
+    std::ofstream out(outputFile, std::ios::out | std::ios::trunc) ;
+    if(!out)
+        return false ;
+
+    bool csv = outputFile.size() > 4 && outputFile.compare(outputFile.size() - 4, 4, ".csv") == 0 ;
+
+    if(csv) {
+        out << "kind,name,count,p50_ns,p99_ns,max_ns,total_ns\n" ;
+        for(int i = 0 ; i < PHASE_COUNT ; i++) {
+            const LatencyHistogram& h = phases[i] ;
+            out << "phase," << phaseName(StepPhase(i)) << "," << h.getCount() << "," << h.percentile(0.50) << ","
+                << h.percentile(0.99) << "," << h.getMax() << "," << h.getTotal() << "\n" ;
+        }
+        for(int i = 0 ; i < ACTION_COUNT ; i++)
+            out << "action," << actionName(ActionType(i)) << "," << actions[i] << ",,,,\n" ;
+
+        if(counters.isAvailable()) {                       //kind,name,event,value
+            out << "\nkind,name,event,value\n" ;
+            for(int i = 0 ; i < PHASE_COUNT ; i++) {
+                for(int e = 0 ; e < PERF_EVENT_COUNT ; e++) {
+                    if(counters.hasEvent(PerfEvent(e)))
+                        out << "perf_phase," << phaseName(StepPhase(i)) << "," << PerfCounters::eventName(PerfEvent(e)) << "," << phasePerf[i].values[e] << "\n" ;
+                }
+            }
+            for(const auto& entry : typePerf) {
+                for(int e = 0 ; e < PERF_EVENT_COUNT ; e++) {
+                    if(counters.hasEvent(PerfEvent(e)))
+                        out << "perf_type," << entry.first << "," << PerfCounters::eventName(PerfEvent(e)) << "," << entry.second.values[e] << "\n" ;
+                }
+            }
+        }
+    }
+    else {
+        out << "{\n  \"steps\": " << stepsRecorded << ",\n  \"phases\": {\n" ;
+        for(int i = 0 ; i < PHASE_COUNT ; i++) {
+            const LatencyHistogram& h = phases[i] ;
+            out << "    \"" << phaseName(StepPhase(i)) << "\": {\"count\": " << h.getCount() << ", \"p50_ns\": " << h.percentile(0.50)
+                << ", \"p99_ns\": " << h.percentile(0.99) << ", \"max_ns\": " << h.getMax() << ", \"total_ns\": " << h.getTotal() << "}"
+                << (i + 1 < PHASE_COUNT ? ",\n" : "\n") ;
+        }
+        out << "  },\n  \"actions\": {" ;
+        for(int i = 0 ; i < ACTION_COUNT ; i++)
+            out << (i ? ", " : "") << "\"" << actionName(ActionType(i)) << "\": " << actions[i] ;
+        out << "}" ;
+
+        if(counters.isAvailable()) {
+            out << ",\n  \"perf_phases\": {\n" ;
+            for(int i = 0 ; i < PHASE_COUNT ; i++) {
+                out << "    \"" << phaseName(StepPhase(i)) << "\": " ;
+                writePerfJson(out, phasePerf[i]) ;
+                out << (i + 1 < PHASE_COUNT ? ",\n" : "\n") ;
+            }
+            out << "  },\n  \"perf_types\": {\n" ;
+            size_t written = 0 ;
+            for(const auto& entry : typePerf) {
+                out << "    \"" << entry.first << "\": " ;
+                writePerfJson(out, entry.second) ;
+                out << (++written < typePerf.size() ? ",\n" : "\n") ;
+            }
+            out << "  }" ;
+        }
+        out << "\n}\n" ;
+    }
+    return static_cast<bool>(out) ;
+}
+
+void TickClock::start(int stepsPerSecond) {
+    rate = stepsPerSecond ;
+    period = std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(1000000000 / rate)) ;
+    deadline = Clock::now() ;
+    jitter = LatencyHistogram() ;
+    overruns = skippedRenders = resyncs = 0 ;
+    lagging = false ;
+}
+
+bool TickClock::waitTick() {
+    std::this_thread::sleep_until(deadline) ;
+    Clock::duration late = std::max(Clock::now() - deadline, Clock::duration::zero()) ;
+    jitter.record(std::chrono::duration_cast<std::chrono::nanoseconds>(late).count()) ;
+    if(late < period / 2 && !lagging)
+        return true ;
+    skippedRenders++ ;
+    return false ;
+}
+
+void TickClock::endStep() {
+    Clock::time_point now = Clock::now() ;
+    deadline += period ;
+    lagging = now > deadline ;                      //ran into the next step's tick
+    if(lagging)
+        overruns++ ;
+    if(now - deadline > MAX_BEHIND * period) {
+        deadline = now ;
+        resyncs++ ;
+    }
+}
+
+void TickClock::report(std::string& out) const {
+    char line[256] ;
+    snprintf(line, sizeof(line), "Real-time %d steps/s: %llu steps, start jitter p50 %.1f us, p90 %.1f us, p99 %.1f us, max %.1f us. "
+             "%llu overruns, %llu renders skipped, %llu resyncs\n", rate, (unsigned long long)jitter.getCount(),
+             jitter.percentile(0.5) / 1000.0, jitter.percentile(0.9) / 1000.0, jitter.percentile(0.99) / 1000.0, jitter.getMax() / 1000.0,
+             (unsigned long long)overruns, (unsigned long long)skippedRenders, (unsigned long long)resyncs) ;
+    out = line ;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Common.h"
+
+enum StepPhase { PHASE_REVIVE, PHASE_TURNS, PHASE_GRAVEYARD, PHASE_UPGRADE, PHASE_DISPLAY, PHASE_GRAVEYARD_PRINT, PHASE_ALIVE_COUNT, PHASE_ROSTER_SORT, PHASE_COUNT } ;
+enum ActionType { ACTION_MOVE, ACTION_SHOT, ACTION_HIT, ACTION_LOOK, ACTION_UPGRADE, ACTION_REVIVE, ACTION_COUNT } ;
+
+class LatencyHistogram {                            //log-linear buckets (16 per power of two), about 6% resolution
+    static const int SUB_BUCKETS = 16 ;
+    uint64_t buckets[64 * SUB_BUCKETS] = {} ;
+    uint64_t count = 0, total = 0, maximum = 0 ;
+
+    static int bucketOf(uint64_t value) ;
+    static uint64_t valueOf(int bucket) ;
+
+public:
+    void record(uint64_t value) ;
+    uint64_t percentile(double p) const ;
+    uint64_t getCount() const { return count ; }
+    uint64_t getTotal() const { return total ; }
+    uint64_t getMax() const { return maximum ; }
+};
+
+enum PerfEvent { PERF_CYCLES, PERF_INSTRUCTIONS, PERF_L1D_MISSES, PERF_LLC_MISSES, PERF_BRANCH_MISSES, PERF_EVENT_COUNT } ;
+
+struct PerfSample {
+    uint64_t values[PERF_EVENT_COUNT] = {} ;
+
+    void add(const PerfSample& before, const PerfSample& after) {
+        for(int i = 0 ; i < PERF_EVENT_COUNT ; i++)
+            values[i] += after.values[i] - before.values[i] ;
+    }
+};
+
+class PerfCounters {                                //one perf_event_open group for this thread, user space only
+    int fds[PERF_EVENT_COUNT] ;
+    int slots[PERF_EVENT_COUNT] ;                   //position inside the group read, -1 = event not supported here
+    int opened = 0 ;
+
+public:
+    PerfCounters() ;
+    ~PerfCounters() ;
+    PerfCounters(const PerfCounters&) = delete ;
+    PerfCounters& operator=(const PerfCounters&) = delete ;
+
+    static const char* eventName(PerfEvent event) ;
+
+    bool open() ;                                   //false when the kernel or the machine does not allow counters
+    bool isAvailable() const { return opened > 0 ; }
+    bool hasEvent(PerfEvent event) const { return slots[event] >= 0 ; }
+    void read(PerfSample& sample) const ;
+};
+
+class StepMetrics {                                 //per phase wall time (ns) and per action counters
+    bool enabled = false ;
+    std::string outputFile ;
+    int flushInterval = 0 ;                         //0 = only at exit
+    int stepsRecorded = 0 ;
+    LatencyHistogram phases[PHASE_COUNT] ;
+    uint64_t actions[ACTION_COUNT] = {} ;
+
+    PerfCounters counters ;
+    PerfSample phasePerf[PHASE_COUNT] ;
+    std::map<std::string, PerfSample> typePerf ;
+
+    void writePerfJson(std::ostream& out, const PerfSample& sample) const ;
+
+public:
+    static const char* phaseName(StepPhase phase) ;
+    static const char* actionName(ActionType action) ;
+
+    void enable(const std::string& filename, int flushEvery) ;
+    bool isEnabled() const { return enabled ; }
+
+    void recordPhase(StepPhase phase, uint64_t nanoseconds) { phases[phase].record(nanoseconds) ; }
+    void countAction(ActionType action) { actions[action]++ ; }
+
+    bool enablePerf() { return counters.open() ; }
+    bool perfEnabled() const { return counters.isAvailable() ; }
+    void readPerf(PerfSample& sample) const { counters.read(sample) ; }
+    void recordPhasePerf(StepPhase phase, const PerfSample& before, const PerfSample& after) { phasePerf[phase].add(before, after) ; }
+    void recordTypePerf(const std::string& type, const PerfSample& before, const PerfSample& after) { typePerf[type].add(before, after) ; }
+    void endStep() ;
+    bool write() const ;                            //JSON, or CSV when the file ends in .csv
+};
+
+class PhaseTimer {                                  //closes the current step phase and starts the next one
+    StepMetrics& metrics ;
+    bool timed, counted ;
+    std::chrono::steady_clock::time_point mark ;
+    PerfSample perfMark, perfNow ;
+
+public:
+    explicit PhaseTimer(StepMetrics& stepMetrics) :
+        metrics(stepMetrics), timed(stepMetrics.isEnabled()), counted(timed && stepMetrics.perfEnabled()) {}
+    bool isCounted() const { return counted ; }
+    void start() ;
+    void done(StepPhase phase) ;
+};
+
+/*fixed rate pacing for real-time runs. steps start on a grid of ticks from the monotonic clock, how late each one
+starts is kept as jitter. a step that starts more than half a tick late, or follows one that overran, skips its
+render (board and graveyard, never the simulation) to catch up, and once the schedule is more than MAX_BEHIND ticks behind it restarts from now
+instead of bursting through the backlog*/
+class TickClock {
+    using Clock = std::chrono::steady_clock ;
+    static constexpr int MAX_BEHIND = 4 ;
+
+    int rate = 0 ;                                  //steps per second, 0 = off
+    Clock::duration period {} ;
+    Clock::time_point deadline ;                    //when the current step should start
+    LatencyHistogram jitter ;                       //ns late per step start
+    uint64_t overruns = 0, skippedRenders = 0, resyncs = 0 ;
+    bool lagging = false ;                          //the last step ran past its tick
+
+public:
+    void start(int stepsPerSecond) ;
+    bool isEnabled() const { return rate > 0 ; }
+    bool waitTick() ;                               //sleeps until the tick, false = behind, skip this step's render
+    void endStep() ;
+    void report(std::string& out) const ;
+};
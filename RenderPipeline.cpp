@@ -0,0 +1,75 @@
+#include "RenderPipeline.h"
+#include "Battlefield.h"
+
+void RenderPipeline::start(Logger* output, const Terrain* board, int depth) {
+    finish() ;
+    logger = output ;
+    terrain = board ;
+    slots.resize(std::max(depth, 1)) ;
+    head = queued = 0 ;
+    closing = false ;
+    worker = std::thread(&RenderPipeline::run, this) ;
+}
+
+RenderPipeline::Frame& RenderPipeline::next() {
+    std::unique_lock<std::mutex> lock(mutex) ;
+    changed.wait(lock, [this] { return queued < slots.size() ; }) ;
+    return slots[(head + queued) % slots.size()] ;
+}
+
+void RenderPipeline::submit() {
+    {
+        std::lock_guard<std::mutex> lock(mutex) ;
+        queued++ ;
+    }
+    changed.notify_all() ;
+}
+
+void RenderPipeline::finish() {
+    if(!worker.joinable())
+        return ;
+    {
+        std::lock_guard<std::mutex> lock(mutex) ;
+        closing = true ;
+    }
+    changed.notify_all() ;
+    worker.join() ;
+}
+
+void RenderPipeline::run() {
+    std::unique_lock<std::mutex> lock(mutex) ;
+    while(true) {
+        changed.wait(lock, [this] { return queued > 0 || closing ; }) ;
+        if(queued == 0)
+            return ;                                //closing and drained
+        const Frame& frame = slots[head] ;
+        lock.unlock() ;                             //the simulation never touches a queued slot
+        render(frame) ;
+        lock.lock() ;
+        head = (head + 1) % slots.size() ;
+        queued-- ;
+        changed.notify_all() ;
+    }
+}
+
+void RenderPipeline::render(const Frame& frame) {
+    out.clear() ;
+    out += frame.text ;
+    if(frame.board) {
+        board.begin(frame.rows, frame.cols, terrain) ;
+        for(const RobotRecord& record : frame.robots)
+            if(record.flags & RobotRecord::ALIVE)
+                board.place(record.x, record.y, NameTable::name(record.nameId)) ;
+        board.write(out) ;
+    }
+    if(frame.graveyard) {
+        out += "Graveyard : " ;
+        for(uint32_t id : frame.dead) {
+            out += "[" ;
+            out += NameTable::name(id) ;
+            out += "] " ;
+        }
+        out += "\n" ;
+    }
+    logger->emit(out) ;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "BoardFormatter.h"
+
+/*pipelined output : the simulation thread fills a frame with everything one step printed (captured log text, then
+the board and graveyard as plain records) and goes on with the next step while the render thread formats and
+writes it. frames are written strictly in submission order and at most depth of them wait at once, next() blocks
+the simulation when the render thread falls that far behind. terrain is read live, it no longer changes once the
+match runs*/
+class RenderPipeline {
+public:
+    struct Frame {
+        std::string text ;                          //log output of the step, written before the board
+        bool board = false ;
+        bool graveyard = false ;
+        int rows = 0, cols = 0 ;
+        std::vector<RobotRecord> robots ;
+        std::vector<uint32_t> dead ;                //graveyard queue, name ids in order
+    };
+
+    ~RenderPipeline() { finish() ; }
+    void start(Logger* output, const Terrain* board, int depth) ;
+    bool isRunning() const { return worker.joinable() ; }
+    Frame& next() ;                                 //free slot to fill, blocks while every slot is queued
+    void submit() ;                                 //hands the slot from next() to the render thread
+    void finish() ;                                 //writes whatever is queued, then stops the thread
+
+private:
+    void run() ;
+    void render(const Frame& frame) ;
+
+    Logger* logger = nullptr ;
+    const Terrain* terrain = nullptr ;
+    std::vector<Frame> slots ;
+    size_t head = 0 ;                               //oldest queued frame, the one being written
+    size_t queued = 0 ;
+    bool closing = false ;
+    std::mutex mutex ;
+    std::condition_variable changed ;
+    std::thread worker ;
+    BoardFormatter board ;                          //render thread only
+    std::string out ;
+};
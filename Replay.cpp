@@ -0,0 +1,426 @@
+#include "Replay.h"
+#include "BoardFormatter.h"
+
+bool ReplayWriter::open(const std::string& filename, int rows, int cols, int keyframeEvery) {
+    out.open(filename, std::ios::out | std::ios::binary | std::ios::trunc) ;
+    if(!out)
+        return false ;
+
+    keyframeInterval = keyframeEvery > 0 ? keyframeEvery : 100 ;
+    buffer.assign("BTLR", 4) ;
+    putVarint(VERSION) ;
+    putVarint(rows) ;
+    putVarint(cols) ;
+    flush() ;
+    return true ;
+}
+
+void ReplayWriter::putVarint(uint64_t value) {
+    while(value >= 0x80) {
+        buffer.push_back(char(value | 0x80)) ;
+        value >>= 7 ;
+    }
+    buffer.push_back(char(value)) ;
+}
+
+void ReplayWriter::putIds(const std::vector<uint32_t>& list) {
+    putVarint(list.size()) ;
+    uint32_t previous = 0 ;
+    for(uint32_t id : list) {
+        putVarint(id - previous) ;
+        previous = id ;
+    }
+}
+
+void ReplayWriter::flush() {
+    out.write(buffer.data(), buffer.size()) ;
+    offset += buffer.size() ;
+    buffer.clear() ;
+}
+
+void ReplayWriter::record(int step, const std::vector<RobotRecord>& records) {
+    if(!out.is_open())
+        return ;
+
+    size_t slots = last.size() ;                                       //records come in roster order, walk them by slot
+    for(const RobotRecord& record : records)
+        slots = std::max<size_t>(slots, record.slot + 1) ;
+    current.assign(slots, -1) ;
+    last.resize(slots, ReplayEntity{EMPTY_SLOT, RobotKind::GenericRobot, 0, 0, false}) ;
+    for(size_t i = 0 ; i < records.size() ; i++) {
+        const RobotRecord& record = records[i] ;
+        current[record.slot] = int32_t(i) ;
+        if(record.nameId >= knownNames.size())
+            knownNames.resize(record.nameId + 1, false) ;
+        knownNames[record.nameId] = true ;
+    }
+
+    putVarint(TAG_STEP) ;
+    putVarint(step) ;
+
+    if(lastKeyframe < 0 || step - lastKeyframe >= keyframeInterval) {
+        index.push_back({uint32_t(step), offset}) ;                   //the index points at this step's TAG_STEP
+        lastKeyframe = step ;
+
+        putVarint(TAG_KEYFRAME) ;
+        putVarint(records.size()) ;
+        uint32_t previous = 0 ;
+        for(uint32_t slot = 0 ; slot < slots ; slot++) {
+            if(current[slot] < 0) {
+                last[slot].nameId = EMPTY_SLOT ;
+                continue ;
+            }
+            const RobotRecord& record = records[current[slot]] ;
+            bool alive = record.flags & RobotRecord::ALIVE ;
+            putVarint(slot - previous) ;
+            putVarint(record.nameId) ;
+            putVarint(static_cast<uint8_t>(record.kind)) ;
+            putVarint(uint16_t(record.x)) ;
+            putVarint(uint16_t(record.y)) ;
+            putVarint(alive) ;
+            previous = slot ;
+            last[slot] = {record.nameId, record.kind, record.x, record.y, alive} ;
+        }
+    }
+    else {
+        for(int tag = 0 ; tag <= TAG_REMOVED ; tag++) {
+            ids[tag].clear() ;
+            payload[tag].clear() ;
+        }
+
+        for(uint32_t slot = 0 ; slot < slots ; slot++) {
+            ReplayEntity& before = last[slot] ;
+            if(before.nameId != EMPTY_SLOT && (current[slot] < 0 || records[current[slot]].nameId != before.nameId)) {
+                ids[TAG_REMOVED].push_back(slot) ;                      //left the roster, or its slot went to another robot
+                before.nameId = EMPTY_SLOT ;
+            }
+            if(current[slot] < 0)
+                continue ;
+
+            const RobotRecord& record = records[current[slot]] ;
+            bool alive = record.flags & RobotRecord::ALIVE ;
+            if(before.nameId == EMPTY_SLOT) {
+                ids[TAG_ADDED].push_back(slot) ;
+                payload[TAG_ADDED].insert(payload[TAG_ADDED].end(),
+                                          {record.nameId, uint32_t(record.kind), uint32_t(uint16_t(record.x)), uint32_t(uint16_t(record.y)), uint32_t(alive)}) ;
+                before = {record.nameId, record.kind, record.x, record.y, alive} ;
+                continue ;
+            }
+
+            if(before.alive && !alive)
+                ids[TAG_DIED].push_back(slot) ;
+            if(!before.alive && alive) {
+                ids[TAG_REVIVED].push_back(slot) ;
+                payload[TAG_REVIVED].insert(payload[TAG_REVIVED].end(), {uint32_t(uint16_t(record.x)), uint32_t(uint16_t(record.y))}) ;
+            }
+            else if(record.x != before.x || record.y != before.y) {
+                ids[TAG_MOVED].push_back(slot) ;
+                payload[TAG_MOVED].insert(payload[TAG_MOVED].end(), {uint32_t(int32_t(record.x - before.x)), uint32_t(int32_t(record.y - before.y))}) ;
+            }
+            if(record.kind != before.kind) {
+                ids[TAG_UPGRADED].push_back(slot) ;
+                payload[TAG_UPGRADED].push_back(uint32_t(record.kind)) ;
+            }
+            before = {record.nameId, record.kind, record.x, record.y, alive} ;
+        }
+
+        if(!ids[TAG_REMOVED].empty()) {                                 //first, a reused slot is removed and then added
+            putVarint(TAG_REMOVED) ;
+            putIds(ids[TAG_REMOVED]) ;
+        }
+        if(!ids[TAG_MOVED].empty()) {
+            putVarint(TAG_MOVED) ;
+            putIds(ids[TAG_MOVED]) ;
+            const std::vector<uint32_t>& moves = payload[TAG_MOVED] ;
+            for(size_t at = 0 ; at < moves.size() ; at += 2) {          //one byte for a step of at most one cell
+                int dx = int32_t(moves[at]), dy = int32_t(moves[at + 1]) ;
+                if(dx >= -1 && dx <= 1 && dy >= -1 && dy <= 1) {
+                    buffer.push_back(char((dx + 1) * 3 + (dy + 1))) ;
+                }
+                else {
+                    buffer.push_back(char(MOVE_ESCAPE)) ;
+                    putZigzag(dx) ;
+                    putZigzag(dy) ;
+                }
+            }
+        }
+        if(!ids[TAG_DIED].empty()) {
+            putVarint(TAG_DIED) ;
+            putIds(ids[TAG_DIED]) ;
+        }
+        for(int tag : {TAG_REVIVED, TAG_UPGRADED, TAG_ADDED}) {         //ids, then their payload values in order
+            if(ids[tag].empty())
+                continue ;
+            putVarint(tag) ;
+            putIds(ids[tag]) ;
+            for(uint32_t value : payload[tag])
+                putVarint(value) ;
+        }
+    }
+
+    if(buffer.size() >= (1 << 16))
+        flush() ;
+}
+
+void ReplayWriter::close() {
+    if(!out.is_open())
+        return ;
+
+    uint64_t footer = offset + buffer.size() ;
+    putVarint(TAG_INDEX) ;
+    putVarint(index.size()) ;
+    for(const auto& entry : index) {
+        putVarint(entry.first) ;
+        putVarint(entry.second) ;
+    }
+
+    putVarint(TAG_NAMES) ;
+    uint32_t count = std::count(knownNames.begin(), knownNames.end(), true) ;
+    putVarint(count) ;
+    for(uint32_t id = 0 ; id < knownNames.size() ; id++) {
+        if(!knownNames[id])
+            continue ;
+        const std::string& name = NameTable::name(id) ;
+        putVarint(id) ;
+        putVarint(name.size()) ;
+        buffer.append(name) ;
+    }
+
+    for(int i = 0 ; i < 8 ; i++)
+        buffer.push_back(char(footer >> (8 * i))) ;
+    buffer.append("BTLR", 4) ;
+    flush() ;
+    out.close() ;
+}
+
+ReplayReader::~ReplayReader() {
+    if(data)
+        munmap(const_cast<uint8_t*>(data), size) ;
+}
+
+uint64_t ReplayReader::getVarint(const uint8_t*& p) {
+    uint64_t value = 0 ;
+    for(int shift = 0 ; shift < 64 ; shift += 7) {
+        if(p >= limit) {
+            overrun = true ;
+            return 0 ;
+        }
+        uint8_t byte = *p++ ;
+        value |= uint64_t(byte & 0x7F) << shift ;
+        if(!(byte & 0x80))
+            break ;
+    }
+    return value ;
+}
+
+bool ReplayReader::open(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY) ;
+    if(fd < 0)
+        return false ;
+    struct stat info ;
+    if(fstat(fd, &info) != 0 || info.st_size < 16) {
+        close(fd) ;
+        return false ;
+    }
+    size = info.st_size ;
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) ;
+    close(fd) ;
+    if(mapped == MAP_FAILED)
+        return false ;
+    data = static_cast<const uint8_t*>(mapped) ;
+
+    if(std::memcmp(data, "BTLR", 4) != 0 || std::memcmp(data + size - 4, "BTLR", 4) != 0)
+        return false ;
+
+    uint64_t footer = 0 ;
+    for(int i = 0 ; i < 8 ; i++)
+        footer |= uint64_t(data[size - 12 + i]) << (8 * i) ;
+    if(footer < 4 || footer > size - 12)
+        return false ;
+
+    const uint8_t* p = data + 4 ;
+    limit = data + footer ;
+    overrun = false ;
+    uint64_t version = getVarint(p) ;
+    uint64_t rowCount = getVarint(p) ;
+    uint64_t colCount = getVarint(p) ;
+    if(overrun || version != ReplayWriter::VERSION || rowCount > uint64_t(SCENARIO_MAX_SIDE) || colCount > uint64_t(SCENARIO_MAX_SIDE))
+        return false ;
+    rows = rowCount ;
+    cols = colCount ;
+
+    p = data + footer ;
+    limit = data + size - 12 ;
+    if(getVarint(p) != ReplayWriter::TAG_INDEX)
+        return false ;
+    uint64_t entries = getVarint(p) ;
+    if(!fits(p, entries * 2))                               //two varints of at least a byte each
+        return false ;
+    index.resize(entries) ;
+    for(auto& entry : index) {
+        uint64_t step = getVarint(p) ;
+        entry.second = getVarint(p) ;
+        if(step > UINT32_MAX || entry.second >= footer || (&entry != &index[0] && step < (&entry - 1)->first))
+            return false ;                                  //seek() bisects, so steps must not go down
+        entry.first = step ;
+    }
+    if(getVarint(p) != ReplayWriter::TAG_NAMES)
+        return false ;
+    uint64_t count = getVarint(p) ;
+    for(uint64_t i = 0 ; i < count && !overrun ; i++) {
+        uint32_t id = getVarint(p) ;
+        uint64_t length = getVarint(p) ;
+        if(!fits(p, length))
+            return false ;
+        names[id] = std::string(reinterpret_cast<const char*>(p), length) ;
+        p += length ;
+    }
+    if(overrun)
+        return false ;
+
+    //last step: walk from the last keyframe to the footer
+    lastStep = 0 ;
+    if(!index.empty() && seek(INT32_MAX))
+        lastStep = currentStep ;
+    return !index.empty() ;
+}
+
+bool ReplayReader::seek(int step) {
+    if(index.empty() || step < 0)
+        return false ;
+
+    auto keyframe = std::upper_bound(index.begin(), index.end(), uint32_t(step),
+                                     [](uint32_t value, const std::pair<uint32_t, uint64_t>& entry) { return value < entry.first ; }) ;
+    if(keyframe == index.begin())
+        return false ;
+    --keyframe ;
+
+    uint64_t footer = 0 ;
+    for(int i = 0 ; i < 8 ; i++)
+        footer |= uint64_t(data[size - 12 + i]) << (8 * i) ;
+
+    const uint8_t* p = data + keyframe->second ;
+    limit = data + footer ;                                 //open() checked both offsets
+    overrun = false ;
+    std::vector<uint32_t> list ;
+    auto readIds = [&]() {
+        uint64_t count = getVarint(p) ;
+        list.resize(fits(p, count) ? count : 0) ;           //at least a byte per id
+        overrun |= list.size() != count ;
+        uint32_t previous = 0 ;
+        for(uint32_t& id : list) {
+            id = previous + getVarint(p) ;
+            previous = id ;
+        }
+    };
+
+    while(p < limit && !overrun) {
+        const uint8_t* recordStart = p ;
+        uint64_t tag = getVarint(p) ;
+
+        if(tag == ReplayWriter::TAG_STEP) {
+            int next = getVarint(p) ;
+            if(next > step) {
+                p = recordStart ;
+                break ;
+            }
+            currentStep = next ;
+        }
+        else if(tag == ReplayWriter::TAG_KEYFRAME) {
+            state.clear() ;
+            uint64_t count = getVarint(p) ;
+            uint32_t previous = 0 ;
+            for(uint64_t i = 0 ; i < count && !overrun ; i++) {
+                uint32_t slot = previous + getVarint(p) ;
+                ReplayEntity entity ;
+                entity.nameId = getVarint(p) ;
+                entity.kind = RobotKind(getVarint(p) % uint64_t(RobotKind::COUNT)) ;
+                entity.x = getVarint(p) ;
+                entity.y = getVarint(p) ;
+                entity.alive = getVarint(p) ;
+                state[slot] = entity ;
+                previous = slot ;
+            }
+        }
+        else if(tag == ReplayWriter::TAG_MOVED) {
+            readIds() ;
+            for(uint32_t slot : list) {
+                if(p >= limit) {
+                    overrun = true ;
+                    break ;
+                }
+                uint8_t packed = *p++ ;
+                int dx, dy ;
+                if(packed == ReplayWriter::MOVE_ESCAPE) {
+                    dx = getZigzag(p) ;
+                    dy = getZigzag(p) ;
+                }
+                else {
+                    dx = packed / 3 - 1 ;
+                    dy = packed % 3 - 1 ;
+                }
+                state[slot].x += dx ;
+                state[slot].y += dy ;
+            }
+        }
+        else if(tag == ReplayWriter::TAG_DIED) {
+            readIds() ;
+            for(uint32_t slot : list)
+                state[slot].alive = false ;
+        }
+        else if(tag == ReplayWriter::TAG_REVIVED) {
+            readIds() ;
+            for(uint32_t slot : list) {
+                state[slot].alive = true ;
+                state[slot].x = getVarint(p) ;
+                state[slot].y = getVarint(p) ;
+            }
+        }
+        else if(tag == ReplayWriter::TAG_UPGRADED) {
+            readIds() ;
+            for(uint32_t slot : list)
+                state[slot].kind = RobotKind(getVarint(p) % uint64_t(RobotKind::COUNT)) ;
+        }
+        else if(tag == ReplayWriter::TAG_ADDED) {
+            readIds() ;
+            for(uint32_t slot : list) {
+                ReplayEntity& entity = state[slot] ;
+                entity.nameId = getVarint(p) ;
+                entity.kind = RobotKind(getVarint(p) % uint64_t(RobotKind::COUNT)) ;
+                entity.x = getVarint(p) ;
+                entity.y = getVarint(p) ;
+                entity.alive = getVarint(p) ;
+            }
+        }
+        else if(tag == ReplayWriter::TAG_REMOVED) {
+            readIds() ;
+            for(uint32_t slot : list)
+                state.erase(slot) ;
+        }
+        else {
+            return false ;                                  //corrupt file
+        }
+    }
+    return !overrun ;
+}
+
+void ReplayReader::display(std::ostream& out) const {
+    BoardFormatter board ;
+    board.begin(rows, cols) ;
+    for(const auto& entry : state) {
+        const ReplayEntity& entity = entry.second ;
+        auto name = names.find(entity.nameId) ;
+        if(entity.alive && name != names.end())
+            board.place(entity.x, entity.y, name->second) ;
+    }
+
+    std::string text ;
+    board.write(text) ;
+    out << "Step: " << currentStep << "\n" << text ;
+    for(const auto& entry : state) {
+        auto name = names.find(entry.second.nameId) ;
+        if(name != names.end())
+            out << name->second << " " << robotKindName(entry.second.kind) << " (" << entry.second.x << "," << entry.second.y << ")"
+                << (entry.second.alive ? "" : " dead") << "\n" ;
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Common.h"
+
+struct ReplayEntity {                               //what a replay knows about one robot (by roster slot)
+    uint32_t nameId ;                               //names repeat, slots do not
+    RobotKind kind ;
+    int16_t x, y ;
+    bool alive ;
+};
+
+/*replay file : "BTLR" header, then per step blocks of varint records. a block is either a keyframe with every
+robot or the deltas against the previous step (moved, died, revived, upgraded, added, removed), robots sorted by
+roster slot and gap coded. keyframes and additions carry the robot's name id. the footer holds the keyframe index and the name table, located by the last 12 bytes*/
+class ReplayWriter {
+public:
+    bool open(const std::string& filename, int rows, int cols, int keyframeEvery) ;
+    bool isOpen() const { return out.is_open() ; }
+    void record(int step, const std::vector<RobotRecord>& records) ;
+    void close() ;
+    ~ReplayWriter() { close() ; }
+
+    enum Tag : uint8_t { TAG_STEP = 1, TAG_KEYFRAME, TAG_MOVED, TAG_DIED, TAG_REVIVED, TAG_UPGRADED, TAG_ADDED, TAG_REMOVED, TAG_INDEX, TAG_NAMES } ;
+    static const uint8_t MOVE_ESCAPE = 0xFF ;      //moved by more than one cell, zigzag dx dy follow
+    static const uint32_t VERSION = 2 ;             //1 keyed robots by name id
+
+private:
+    std::ofstream out ;
+    std::string buffer ;
+    uint64_t offset = 0 ;
+    int keyframeInterval = 100 ;
+    int lastKeyframe = -1 ;
+    static const uint32_t EMPTY_SLOT = UINT32_MAX ;          //nameId of a slot with no robot in last
+    std::vector<ReplayEntity> last ;                        //by roster slot, as of the previous step
+    std::vector<int32_t> current ;                          //by roster slot, index into this step's records or -1
+    std::vector<bool> knownNames ;
+    std::vector<std::pair<uint32_t, uint64_t>> index ;      //keyframe step, file offset
+    std::vector<uint32_t> ids[TAG_REMOVED + 1] ;            //per delta tag, this step's robots in slot order
+    std::vector<uint32_t> payload[TAG_REMOVED + 1] ;        //per delta tag, the values that follow the ids
+
+    void putVarint(uint64_t value) ;
+    void putZigzag(int64_t value) { putVarint((uint64_t(value) << 1) ^ uint64_t(value >> 63)) ; }
+    void putIds(const std::vector<uint32_t>& list) ;
+    void flush() ;
+};
+
+class ReplayReader {                                        //maps the file, seek(step) rebuilds the board at that step
+public:
+    ~ReplayReader() ;
+    bool open(const std::string& filename) ;
+    bool seek(int step) ;
+    void display(std::ostream& out) const ;
+    int getLastStep() const { return lastStep ; }
+
+private:
+    const uint8_t* data = nullptr ;
+    size_t size = 0 ;
+    int rows = 0, cols = 0 ;
+    int lastStep = 0 ;
+    int currentStep = -1 ;
+    std::vector<std::pair<uint32_t, uint64_t>> index ;
+    std::unordered_map<uint32_t, std::string> names ;
+    std::map<uint32_t, ReplayEntity> state ;        //by roster slot
+    const uint8_t* limit = nullptr ;                //end of the region being decoded
+    bool overrun = false ;                          //a read went past limit, the file is corrupt
+
+    uint64_t getVarint(const uint8_t*& p) ;         //0 and overrun set past limit
+    int64_t getZigzag(const uint8_t*& p) { uint64_t v = getVarint(p) ; return int64_t(v >> 1) ^ -int64_t(v & 1) ; }
+    bool fits(const uint8_t* p, uint64_t bytes) const { return p <= limit && bytes <= uint64_t(limit - p) ; }
+};
@@ -0,0 +1,56 @@
+#include "RobotSlots.h"
+#include "Battlefield.h"
+
+RobotHandle RobotSlots::insert(Robot* robot) {
+    uint32_t index ;
+    if(freeSlot != UINT32_MAX) {
+        index = freeSlot ;
+        freeSlot = slots[index].position ;
+    }
+    else {
+        index = slots.size() ;
+        slots.emplace_back() ;
+    }
+    slots[index].robot = robot ;
+    slots[index].position = dense.size() ;
+    dense.push_back(robot) ;
+    return {index, slots[index].generation} ;
+}
+
+void RobotSlots::remove(RobotHandle handle) {
+    if(!get(handle))
+        return ;
+    Slot& slot = slots[handle.index] ;
+    dense[slot.position] = nullptr ;
+    holes++ ;
+    slot.robot = nullptr ;
+    slot.generation++ ;                             //every handle to it is stale from now on
+    slot.position = freeSlot ;
+    freeSlot = handle.index ;
+}
+
+void RobotSlots::compact() {
+    if(holes == 0)
+        return ;
+    size_t kept = 0 ;
+    for(Robot* robot : dense) {
+        if(robot) {
+            slots[robot->getHandle().index].position = kept ;
+            dense[kept++] = robot ;
+        }
+    }
+    dense.resize(kept) ;
+    holes = 0 ;
+}
+
+void RobotSlots::reindex() {
+    for(size_t i = 0 ; i < dense.size() ; i++)
+        slots[dense[i]->getHandle().index].position = i ;
+}
+
+void RobotSlots::clear() {
+    slots.clear() ;
+    dense.clear() ;
+    freeSlot = UINT32_MAX ;
+    holes = 0 ;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Common.h"
+
+struct RobotHandle {                                //slot index and generation, goes stale once its robot leaves the roster
+    uint32_t index = UINT32_MAX ;
+    uint32_t generation = 0 ;
+
+    bool operator==(const RobotHandle& other) const { return index == other.index && generation == other.generation ; }
+    bool operator!=(const RobotHandle& other) const { return !(*this == other) ; }
+};
+
+/*the roster as a generational slot map. a handle names a slot and the slot's generation moves on when its robot is
+removed, so get() of an old handle gives nullptr instead of a dangling pointer. the robots sit in a dense array in
+turn order : insert() appends and remove() leaves a null behind, both O(1), and compact() closes the gaps in one
+order keeping pass once the battlefield is done changing the roster. index loops over the dense array stay valid
+while robots come and go, they only skip the nulls*/
+class RobotSlots {
+    struct Slot {
+        Robot* robot = nullptr ;
+        uint32_t generation = 0 ;
+        uint32_t position = 0 ;                     //index in dense while used, next free slot otherwise
+    };
+
+    std::vector<Slot> slots ;
+    std::vector<Robot*> dense ;
+    uint32_t freeSlot = UINT32_MAX ;
+    size_t holes = 0 ;
+
+public:
+    RobotHandle insert(Robot* robot) ;
+    void remove(RobotHandle handle) ;               //the caller still owns the robot
+    Robot* get(RobotHandle handle) const {
+        return handle.index < slots.size() && slots[handle.index].generation == handle.generation ? slots[handle.index].robot : nullptr ;
+    }
+    size_t position(RobotHandle handle) const { return slots[handle.index].position ; }     //live handles only
+    void compact() ;
+    void reindex() ;                                //after the dense array was reordered through operator[]
+    void clear() ;
+    void reserve(size_t count) { dense.reserve(count) ; }
+
+    const std::vector<Robot*>& all() const { return dense ; }
+    size_t size() const { return dense.size() ; }   //holes included until compact()
+    bool empty() const { return dense.empty() ; }
+    Robot*& operator[](size_t i) { return dense[i] ; }
+    Robot* operator[](size_t i) const { return dense[i] ; }
+    std::vector<Robot*>::const_iterator begin() const { return dense.begin() ; }
+    std::vector<Robot*>::const_iterator end() const { return dense.end() ; }
+};
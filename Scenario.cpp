@@ -0,0 +1,317 @@
+#include "Scenario.h"
+#include "Battlefield.h"
+
+ScenarioReader::ScenarioReader(const std::string& filename, size_t blockSize)
+    : file(filename, std::ios::in | std::ios::binary), buffer(blockSize) {}
+
+ScenarioReader ScenarioReader::fromText(std::string_view text) {
+    ScenarioReader reader("", 0) ;
+    reader.buffer.assign(text.begin(), text.end()) ;
+    reader.buffer.push_back('\n') ;                         //memchr never runs off the end
+    reader.end = text.size() ;
+    reader.eof = true ;
+    reader.inMemory = true ;
+    return reader ;
+}
+
+bool ScenarioReader::nextLine(std::string_view& line) {
+    while(true) {
+        const char* first = buffer.data() + begin ;
+        const char* newline = static_cast<const char*>(memchr(first, '\n', end - begin)) ;
+
+        if(newline) {
+            line = std::string_view(first, newline - first) ;
+            begin += line.size() + 1 ;
+            break ;
+        }
+
+        if(eof) {
+            if(begin == end)
+                return false ;
+            line = std::string_view(first, end - begin) ;           //last line without a newline
+            begin = end ;
+            break ;
+        }
+
+        if(begin > 0) {                                             //keep the partial line, make room for the next block
+            std::copy(buffer.begin() + begin, buffer.begin() + end, buffer.begin()) ;
+            end -= begin ;
+            begin = 0 ;
+        }
+        if(end == buffer.size())                                    //a single line longer than the block
+            buffer.resize(buffer.size() * 2) ;
+
+        file.read(buffer.data() + end, buffer.size() - end) ;
+        end += file.gcount() ;
+        if(!file)
+            eof = true ;
+    }
+
+    if(!line.empty() && line.back() == '\r')
+        line.remove_suffix(1) ;
+    lineNumber++ ;
+    return true ;
+}
+
+bool ScenarioReader::next(Line& line) {
+    std::string_view text ;
+    if(!nextLine(text)) {
+        if(!inScript)
+            return false ;
+        inScript = false ;                          //the file ended inside a script block
+        line = Line() ;
+        line.kind = INVALID ;
+        line.error = "unterminated script, no \"end\" line" ;
+        return true ;
+    }
+
+    if(inScript) {
+        line = Line() ;
+        size_t first = text.find_first_not_of(" \t\r") ;
+        size_t last = text.find_last_not_of(" \t\r") ;
+        bool end = first != std::string_view::npos && text.substr(first, last - first + 1) == "end" ;
+        line.kind = end ? SCRIPT_END : SCRIPT_LINE ;
+        line.cells = text ;
+        inScript = !end ;
+        return true ;
+    }
+
+    parse(text, line) ;
+    inScript = line.kind == SCRIPT ;
+    return true ;
+}
+
+void ScenarioReader::parse(std::string_view text, Line& line) {
+    const int MAX_TOKENS = 8 ;
+    std::string_view tokens[MAX_TOKENS] ;
+    int count = 0 ;
+
+    size_t pos = 0 ;
+    while(count < MAX_TOKENS) {
+        pos = text.find_first_not_of(" \t", pos) ;
+        if(pos == std::string_view::npos)
+            break ;
+        size_t stop = text.find_first_of(" \t", pos) ;
+        if(stop == std::string_view::npos)
+            stop = text.size() ;
+        tokens[count++] = text.substr(pos, stop - pos) ;
+        pos = stop ;
+    }
+
+    auto toInt = [](std::string_view token, int& out) {
+        auto result = std::from_chars(token.data(), token.data() + token.size(), out) ;
+        return result.ec == std::errc() && result.ptr == token.data() + token.size() ;
+    };
+
+    line = Line() ;
+
+    if(text.find("M by N") != std::string_view::npos) {
+        //M by N : 40 50
+        if(count >= 2 && toInt(tokens[count - 2], line.rows) && toInt(tokens[count - 1], line.cols))
+            line.kind = SIZE ;
+        if(line.kind == SIZE && (line.rows < 1 || line.cols < 1 || line.rows > SCENARIO_MAX_SIDE || line.cols > SCENARIO_MAX_SIDE)) {
+            line.kind = INVALID ;
+            line.error = "board size must be 1 to 4096 rows and columns" ;
+        }
+    }
+    else if(text.find("steps:") != std::string_view::npos) {
+        if(count >= 2 && toInt(tokens[1], line.value))
+            line.kind = line.value >= 0 ? STEPS : INVALID ;
+        if(line.kind == INVALID)
+            line.error = "negative step count" ;
+    }
+    else if(text.find("robots:") != std::string_view::npos) {
+        if(count >= 2 && toInt(tokens[1], line.value))
+            line.kind = line.value >= 0 && line.value <= SCENARIO_MAX_ROBOTS ? ROBOTS : INVALID ;
+        if(line.kind == INVALID)
+            line.error = "robot count must be 0 to 1048576" ;
+    }
+    else if(text.find("script:") != std::string_view::npos) {
+        //script: hunter , the program follows up to a line holding only "end"
+        if(count >= 2 && tokens[0] == "script:") {
+            line.kind = SCRIPT ;
+            line.name = tokens[1] ;
+        }
+    }
+    else if(text.find("GenericRobot") != std::string_view::npos && count >= 4) {
+        //GenericRobot Kidd 3 6 [team=1] [script=hunter] , either coordinate can be "random"
+        line.kind = ROBOT ;
+        line.type = tokens[0] ;
+        line.name = tokens[1] ;
+        line.randomX = tokens[2] == "random" ;
+        line.randomY = tokens[3] == "random" ;
+        if((!line.randomX && !toInt(tokens[2], line.x)) || (!line.randomY && !toInt(tokens[3], line.y))) {
+            line.kind = INVALID ;
+            line.error = "robot position must be a number or random" ;
+            return ;
+        }
+        for(int i = 4 ; i < count ; i++) {
+            if(tokens[i].substr(0, 5) == "team=" && !toInt(tokens[i].substr(5), line.team))
+                line.team = 0 ;
+            else if(tokens[i].substr(0, 7) == "script=")
+                line.script = tokens[i].substr(7) ;
+        }
+        line.team = std::max(0, std::min(255, line.team)) ;
+    }
+    else if(text.find("terrain:") != std::string_view::npos) {
+        line.kind = TERRAIN ;
+    }
+    else if(count == 1 && tokens[0].find_first_not_of(".#%~") == std::string_view::npos) {
+        //..#..%%~~.. , a terrain row, see Terrain::fromChar
+        line.kind = TERRAIN_ROW ;
+        line.cells = tokens[0] ;
+    }
+}
+
+bool Battlefield::compileScenario(const std::string& textFile, const std::string& binaryFile, uint32_t seed) {
+    ScenarioReader reader(textFile) ;
+    if(!reader.isOpen())
+        return false ;
+
+    BinaryScenarioHeader header = {} ;
+    std::memcpy(header.magic, "BTLS", 4) ;
+    header.version = BINARY_SCENARIO_VERSION ;
+    header.seed = seed ;
+
+    std::vector<BinaryScenarioRobot> table ;
+    std::string names ;
+
+    ScenarioReader::Line line ;
+    while(reader.next(line)) {
+        if(line.kind == ScenarioReader::INVALID)
+            return false ;
+        else if(line.kind == ScenarioReader::SIZE) {
+            header.rows = line.rows ;
+            header.cols = line.cols ;
+        }
+        else if(line.kind == ScenarioReader::STEPS) {
+            header.steps = line.value ;
+        }
+        else if(line.kind == ScenarioReader::ROBOTS) {
+            table.reserve(line.value) ;
+        }
+        else if(line.kind == ScenarioReader::ROBOT) {
+            BinaryScenarioRobot robot ;
+            robot.x = line.randomX ? -1 : line.x ;
+            robot.y = line.randomY ? -1 : line.y ;
+            robot.nameOffset = names.size() ;
+            robot.nameLength = std::max<size_t>(line.name.size(), 3) ;
+            robot.team = line.team ;
+            robot.kind = uint32_t(robotKindFromName(line.type)) ;
+            names.append(line.name) ;
+            if(line.name.size() < 3)
+                names.append("_") ;                 //short names are padded like the text loader does
+            table.push_back(robot) ;
+        }
+    }
+
+    //positions are settled here, the way the text loader settles them at load time, so loading is only copying.
+    //random cells come from the compile seed, taken or off-board cells are drawn again, robots past a full board are dropped
+    if(header.rows < 1 || header.cols < 1)
+        return false ;
+    unsigned state = seed ;
+    std::vector<bool> taken(size_t(header.rows) * header.cols, false) ;
+    size_t freeCells = taken.size(), kept = 0 ;
+    for(BinaryScenarioRobot robot : table) {
+        if(freeCells == 0)
+            break ;
+        if(robot.x < 0)
+            robot.x = rand_r(&state) % header.cols ;
+        if(robot.y < 0)
+            robot.y = rand_r(&state) % header.rows ;
+        while(robot.x >= header.cols || robot.y >= header.rows || taken[size_t(robot.y) * header.cols + robot.x]) {
+            robot.x = rand_r(&state) % header.cols ;
+            robot.y = rand_r(&state) % header.rows ;
+        }
+        taken[size_t(robot.y) * header.cols + robot.x] = true ;
+        freeCells-- ;
+        table[kept++] = robot ;
+    }
+    table.resize(kept) ;
+
+    header.robotCount = table.size() ;
+    header.namesSize = names.size() ;
+
+    std::ofstream out(binaryFile, std::ios::out | std::ios::binary) ;
+    if(!out)
+        return false ;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header)) ;
+    out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(BinaryScenarioRobot)) ;
+    out.write(names.data(), names.size()) ;
+    return static_cast<bool>(out) ;
+}
+
+bool Battlefield::loadFromBinary(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY) ;
+    if(fd < 0) {
+        getLogger()->log("Cannot open ", filename, "\n") ;
+        return false ;
+    }
+
+    struct stat info ;
+    if(fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(BinaryScenarioHeader)) {
+        close(fd) ;
+        getLogger()->log(filename, " is not a compiled scenario\n") ;
+        return false ;
+    }
+
+    size_t size = info.st_size ;
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) ;
+    close(fd) ;
+    if(mapped == MAP_FAILED) {
+        getLogger()->log("Cannot map ", filename, "\n") ;
+        return false ;
+    }
+
+    const char* data = static_cast<const char*>(mapped) ;
+    const BinaryScenarioHeader* header = reinterpret_cast<const BinaryScenarioHeader*>(data) ;
+    size_t expected = sizeof(BinaryScenarioHeader) + size_t(header->robotCount) * sizeof(BinaryScenarioRobot) + header->namesSize ;
+
+    if(std::memcmp(header->magic, "BTLS", 4) != 0 || header->version != BINARY_SCENARIO_VERSION || size < expected) {
+        munmap(mapped, size) ;
+        getLogger()->log(filename, " is not a compiled scenario\n") ;
+        return false ;
+    }
+    if(header->rows < 1 || header->cols < 1 || header->rows > SCENARIO_MAX_SIDE || header->cols > SCENARIO_MAX_SIDE
+       || header->steps < 0 || header->robotCount > uint32_t(SCENARIO_MAX_ROBOTS)) {             //same limits as the text reader
+        munmap(mapped, size) ;
+        getLogger()->log(filename, " has an invalid board size, step or robot count\n") ;
+        return false ;
+    }
+
+    const BinaryScenarioRobot* table = reinterpret_cast<const BinaryScenarioRobot*>(data + sizeof(BinaryScenarioHeader)) ;
+    const char* names = data + sizeof(BinaryScenarioHeader) + size_t(header->robotCount) * sizeof(BinaryScenarioRobot) ;
+    for(uint32_t i = 0 ; i < header->robotCount ; i++) {           //the compiler placed every robot, a table that disagrees is corrupt
+        const BinaryScenarioRobot& robot = table[i] ;
+        if(size_t(robot.nameOffset) + robot.nameLength > header->namesSize || robot.nameLength == 0 || robot.kind >= uint32_t(RobotKind::COUNT)
+           || robot.team > 255 || robot.x < 0 || robot.y < 0 || robot.x >= header->cols || robot.y >= header->rows) {
+            munmap(mapped, size) ;
+            getLogger()->log(filename, " has a corrupt robot table\n") ;
+            return false ;
+        }
+    }
+
+    setRows(header->rows) ;
+    setCols(header->cols) ;
+    setSteps(header->steps) ;
+    if(header->seed != 0)
+        seedRandom(header->seed) ;
+    robots.reserve(robots.size() + header->robotCount) ;
+
+    std::string name ;
+    for(uint32_t i = 0 ; i < header->robotCount ; i++) {
+        const BinaryScenarioRobot& entry = table[i] ;
+        name.assign(names + entry.nameOffset, entry.nameLength) ;
+        Robot* robot = buildRobot(RobotKind(entry.kind), name, entry.x, entry.y) ;
+        robot->setTeam(entry.team) ;
+        if(entry.team != 0)
+            teamsInPlay = true ;
+        *this << robot ;
+    }
+
+    munmap(mapped, size) ;
+
+    getLogger()->log("Finished loading compiled scenario. Battlefield size: ", cols, "x", rows,
+                       ", Steps: ", steps, ", Robots: ", robots.size(), "\n") ;
+    return true ;
+}
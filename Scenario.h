@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Common.h"
+
+class ScenarioReader {                              //streams the scenario file in blocks, no per-line allocation
+public:
+    enum LineKind { SIZE, STEPS, ROBOTS, ROBOT, TERRAIN, TERRAIN_ROW, SCRIPT, SCRIPT_LINE, SCRIPT_END, INVALID, OTHER } ;
+
+    struct Line {
+        LineKind kind = OTHER ;
+        int rows = 0, cols = 0 ;                    //SIZE
+        int value = 0 ;                             //STEPS, ROBOTS
+        std::string_view type, name ;               //ROBOT (name also for SCRIPT), only valid until the next call to next()
+        std::string_view script ;                   //optional "script=NAME" token of a ROBOT line
+        int x = 0, y = 0 ;
+        bool randomX = false, randomY = false ;
+        int team = 0 ;                              //optional "team=N" token, 0 = no team
+        std::string_view cells ;                    //TERRAIN_ROW, one character per cell. SCRIPT_LINE, the raw text
+        const char* error = "" ;                    //INVALID, what is wrong with the line
+    };
+
+    explicit ScenarioReader(const std::string& filename, size_t blockSize = 1 << 16) ;
+    static ScenarioReader fromText(std::string_view text) ;   //a scenario already in memory, e.g. a service job
+
+    bool isOpen() const { return inMemory || file.is_open() ; }
+    bool next(Line& line) ;
+    int getLineNumber() const { return lineNumber ; }   //of the line next() returned last
+
+private:
+    std::ifstream file;
+    std::vector<char> buffer ;
+    size_t begin = 0, end = 0 ;
+    bool eof = false ;
+    bool inMemory = false ;
+    bool inScript = false ;                         //between "script: NAME" and "end", lines pass through untouched
+    int lineNumber = 0 ;
+
+    bool nextLine(std::string_view& line) ;
+    static void parse(std::string_view text, Line& line) ;
+};
+
+//compiled scenario (.bin) : header, packed robot table, then the name bytes the table points into
+struct BinaryScenarioHeader {
+    char magic[4] ;                 //"BTLS"
+    uint32_t version ;
+    int32_t rows, cols, steps ;
+    uint32_t seed ;                 //0 = keep the current rand() seed
+    uint32_t robotCount ;
+    uint32_t namesSize ;
+};
+
+struct BinaryScenarioRobot {
+    int32_t x, y ;                  //placed by the compiler : on the board, no two robots on one cell
+    uint32_t nameOffset ;
+    uint32_t nameLength ;
+    uint32_t team ;                 //0 = no team
+    uint32_t kind ;                 //RobotKind
+};
+
+const uint32_t BINARY_SCENARIO_VERSION = 4 ;       //3 left random positions to the loader
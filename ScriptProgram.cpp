@@ -0,0 +1,193 @@
+#include "ScriptProgram.h"
+#include "Battlefield.h"
+
+struct ScriptOpInfo {
+    const char* name ;
+    ScriptOp op ;
+    const char* operands ;                          //r register, i constant, l label
+    int span ;                                      //registers written from the first operand on
+};
+
+static const ScriptOpInfo scriptOps[] = {
+    {"halt", OP_HALT, "", 0}, {"set", OP_SET, "ri", 1}, {"mov", OP_MOV, "rr", 1},
+    {"add", OP_ADD, "rrr", 1}, {"sub", OP_SUB, "rrr", 1}, {"mul", OP_MUL, "rrr", 1}, {"div", OP_DIV, "rrr", 1}, {"mod", OP_MOD, "rrr", 1},
+    {"addi", OP_ADDI, "rri", 1}, {"lt", OP_LT, "rrr", 1}, {"le", OP_LE, "rrr", 1}, {"eq", OP_EQ, "rrr", 1}, {"ne", OP_NE, "rrr", 1},
+    {"sign", OP_SIGN, "rr", 1}, {"abs", OP_ABS, "rr", 1}, {"jmp", OP_JMP, "l", 0}, {"jz", OP_JZ, "rl", 0}, {"jnz", OP_JNZ, "rl", 0},
+    {"rand", OP_RAND, "ri", 1}, {"self", OP_SELF, "r", 4}, {"nearest", OP_NEAREST, "r", 4}, {"count", OP_COUNT, "rr", 1},
+    {"target", OP_TARGET, "r", 3}, {"think", OP_THINK, "", 0}, {"aimlook", OP_AIMLOOK, "rr", 1}, {"aimfire", OP_AIMFIRE, "rr", 1},
+    {"aimmove", OP_AIMMOVE, "rr", 1}, {"look", OP_LOOK, "rr", 0}, {"fire", OP_FIRE, "rr", 0}, {"move", OP_MOVE, "rr", 0},
+} ;
+
+bool ScriptProgram::assemble(std::string_view source, std::string& error) {
+    struct Pending { int line ; const ScriptOpInfo* info ; std::vector<std::string_view> operands ; } ;
+    std::vector<Pending> pending ;
+    std::vector<std::pair<std::string_view, int>> labels ;
+
+    auto fail = [&error](int line, const std::string& message) {
+        error = "line " + std::to_string(line) + ": " + message ;
+        return false ;
+    };
+
+    //first pass : split into instructions and note where every label points
+    int lineNumber = 0 ;
+    size_t pos = 0 ;
+    while(pos < source.size()) {
+        size_t stop = source.find('\n', pos) ;
+        if(stop == std::string_view::npos)
+            stop = source.size() ;
+        std::string_view text = source.substr(pos, stop - pos) ;
+        pos = stop + 1 ;
+        lineNumber++ ;
+        text = text.substr(0, text.find_first_of("#;")) ;          //comments
+
+        std::vector<std::string_view> tokens ;
+        size_t at = 0 ;
+        while((at = text.find_first_not_of(" \t\r,", at)) != std::string_view::npos) {
+            size_t end = text.find_first_of(" \t\r,", at) ;
+            if(end == std::string_view::npos)
+                end = text.size() ;
+            tokens.push_back(text.substr(at, end - at)) ;
+            at = end ;
+        }
+        size_t first = 0 ;
+        if(!tokens.empty() && tokens[0].back() == ':') {           //label, maybe followed by an instruction
+            labels.push_back({tokens[0].substr(0, tokens[0].size() - 1), int(pending.size())}) ;
+            first = 1 ;
+        }
+        if(first == tokens.size())
+            continue ;
+
+        const ScriptOpInfo* info = nullptr ;
+        for(const ScriptOpInfo& candidate : scriptOps)
+            if(tokens[first] == candidate.name)
+                info = &candidate ;
+        if(!info)
+            return fail(lineNumber, "unknown instruction " + std::string(tokens[first])) ;
+        if(tokens.size() - first - 1 != std::strlen(info->operands))
+            return fail(lineNumber, std::string(info->name) + " takes " + std::to_string(std::strlen(info->operands)) + " operands") ;
+        pending.push_back({lineNumber, info, std::vector<std::string_view>(tokens.begin() + first + 1, tokens.end())}) ;
+    }
+
+    //second pass : encode, now that every label is known
+    code.clear() ;
+    code.reserve(pending.size() + 1) ;
+    for(const Pending& entry : pending) {
+        ScriptInstruction instruction = {entry.info->op, 0, 0, 0, 0} ;
+        uint8_t* registers[] = {&instruction.a, &instruction.b, &instruction.c} ;
+        int registerCount = 0 ;
+        for(size_t i = 0 ; i < entry.operands.size() ; i++) {
+            std::string_view operand = entry.operands[i] ;
+            char kind = entry.info->operands[i] ;
+            if(kind == 'r') {
+                int index = -1 ;
+                if(operand.size() < 2 || operand[0] != 'r'
+                   || std::from_chars(operand.data() + 1, operand.data() + operand.size(), index).ptr != operand.data() + operand.size()
+                   || index < 0 || index >= REGISTERS)
+                    return fail(entry.line, "bad register " + std::string(operand)) ;
+                *registers[registerCount++] = uint8_t(index) ;
+            }
+            else if(kind == 'i') {
+                auto result = std::from_chars(operand.data(), operand.data() + operand.size(), instruction.imm) ;
+                if(result.ec != std::errc() || result.ptr != operand.data() + operand.size())
+                    return fail(entry.line, "bad number " + std::string(operand)) ;
+            }
+            else {
+                auto label = std::find_if(labels.begin(), labels.end(), [operand](const auto& known) { return known.first == operand ; }) ;
+                if(label == labels.end())
+                    return fail(entry.line, "unknown label " + std::string(operand)) ;
+                instruction.imm = label->second ;
+            }
+        }
+        if(instruction.a + entry.info->span > REGISTERS)
+            return fail(entry.line, std::string(entry.info->name) + " writes " + std::to_string(entry.info->span) + " registers from its first one") ;
+        if(instruction.op == OP_RAND && instruction.imm <= 0)
+            return fail(entry.line, "rand needs a positive bound") ;
+        code.push_back(instruction) ;
+    }
+    code.push_back({OP_HALT, 0, 0, 0, 0}) ;         //falling off the end finishes the turn, labels may point here
+    return true ;
+}
+
+static int clampDirection(int32_t value) { return (value > 0) - (value < 0) ; }
+
+void ScriptProgram::run(GenericRobot& self) const {
+    int32_t r[REGISTERS] = {} ;
+    const ScriptInstruction* start = code.data() ;
+    const ScriptInstruction* pc = start ;
+    int jumps = BACKWARD_JUMPS ;
+    const SpatialIndex& spatial = self.getBattlefield()->getSpatialIndex() ;
+    enum { THOUGHT = 1, LOOKED = 2, FIRED = 4, MOVED = 8 } ;
+    unsigned acted = 0 ;                            //one action of each kind per turn, like the built-in turn. repeats do nothing
+
+    while(true) {
+        const ScriptInstruction& in = *pc++ ;
+        switch(in.op) {
+        case OP_HALT:
+            return ;
+        case OP_SET: r[in.a] = in.imm ; break ;
+        case OP_MOV: r[in.a] = r[in.b] ; break ;
+        case OP_ADD: r[in.a] = int32_t(uint32_t(r[in.b]) + uint32_t(r[in.c])) ; break ;      //wraps instead of overflowing
+        case OP_SUB: r[in.a] = int32_t(uint32_t(r[in.b]) - uint32_t(r[in.c])) ; break ;
+        case OP_MUL: r[in.a] = int32_t(uint32_t(r[in.b]) * uint32_t(r[in.c])) ; break ;
+        case OP_DIV: r[in.a] = r[in.c] == 0 || (r[in.c] == -1 && r[in.b] == INT32_MIN) ? 0 : r[in.b] / r[in.c] ; break ;
+        case OP_MOD: r[in.a] = r[in.c] == 0 || r[in.c] == -1 ? 0 : r[in.b] % r[in.c] ; break ;
+        case OP_ADDI: r[in.a] = int32_t(uint32_t(r[in.b]) + uint32_t(in.imm)) ; break ;
+        case OP_LT: r[in.a] = r[in.b] < r[in.c] ; break ;
+        case OP_LE: r[in.a] = r[in.b] <= r[in.c] ; break ;
+        case OP_EQ: r[in.a] = r[in.b] == r[in.c] ; break ;
+        case OP_NE: r[in.a] = r[in.b] != r[in.c] ; break ;
+        case OP_SIGN: r[in.a] = clampDirection(r[in.b]) ; break ;
+        case OP_ABS: r[in.a] = r[in.b] < 0 ? int32_t(0u - uint32_t(r[in.b])) : r[in.b] ; break ;
+        case OP_JZ:
+        case OP_JNZ:
+            if((r[in.a] == 0) != (in.op == OP_JZ))
+                break ;
+            [[fallthrough]] ;
+        case OP_JMP:
+            if(start + in.imm < pc && --jumps < 0)
+                return ;                            //out of backward jumps, the turn is over
+            pc = start + in.imm ;
+            break ;
+        case OP_RAND: r[in.a] = self.roll() % in.imm ; break ;
+        case OP_SELF:
+            r[in.a] = self.getX() ;
+            r[in.a + 1] = self.getY() ;
+            r[in.a + 2] = self.getShells() ;
+            r[in.a + 3] = self.getLives() ;
+            break ;
+        case OP_NEAREST: {
+            const Robot* other = spatial.nearest(self.getX(), self.getY(), &self, self.getTeam()) ;
+            r[in.a] = other != nullptr ;
+            r[in.a + 1] = other ? other->getX() : 0 ;
+            r[in.a + 2] = other ? other->getY() : 0 ;
+            r[in.a + 3] = other ? std::max(std::abs(other->getX() - self.getX()), std::abs(other->getY() - self.getY())) : 0 ;
+            break ;
+        }
+        case OP_COUNT: r[in.a] = spatial.countWithin(self.getX(), self.getY(), std::max(r[in.b], 0), &self, self.getTeam()) ; break ;
+        case OP_TARGET: r[in.a] = self.getTarget(r[in.a + 1], r[in.a + 2]) ; break ;
+        case OP_THINK:
+            if(!(acted & THOUGHT))
+                self.think() ;
+            acted |= THOUGHT ;
+            break ;
+        case OP_AIMLOOK: self.aimLook(r[in.a], r[in.b]) ; break ;
+        case OP_AIMFIRE: self.aimFire(r[in.a], r[in.b]) ; break ;
+        case OP_AIMMOVE: self.aimMove(r[in.a], r[in.b]) ; break ;
+        case OP_LOOK:
+            if(!(acted & LOOKED))
+                self.look(clampDirection(r[in.a]), clampDirection(r[in.b])) ;
+            acted |= LOOKED ;
+            break ;
+        case OP_FIRE:
+            if(!(acted & FIRED))
+                self.fire(clampDirection(r[in.a]), clampDirection(r[in.b])) ;
+            acted |= FIRED ;
+            break ;
+        case OP_MOVE:
+            if(!(acted & MOVED))
+                self.move(clampDirection(r[in.a]), clampDirection(r[in.b])) ;
+            acted |= MOVED ;
+            break ;
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Common.h"
+
+/*robot behaviour written in the scenario file. a "script: NAME" block is assembled once into register bytecode, and
+every robot line carrying script=NAME then runs it as its whole turn instead of GenericRobot::takeTurn. 16 integer
+registers start at zero each turn. look, fire and move go through the robot's own (possibly upgraded) abilities,
+queries fill several registers in one instruction. jumps back are limited per turn so a script cannot hang a step.
+see the README for the instruction set*/
+enum ScriptOp : uint8_t {
+    OP_HALT, OP_SET, OP_MOV, OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_MOD, OP_ADDI, OP_LT, OP_LE, OP_EQ, OP_NE,
+    OP_SIGN, OP_ABS, OP_JMP, OP_JZ, OP_JNZ, OP_RAND, OP_SELF, OP_NEAREST, OP_COUNT, OP_TARGET,
+    OP_THINK, OP_AIMLOOK, OP_AIMFIRE, OP_AIMMOVE, OP_LOOK, OP_FIRE, OP_MOVE
+} ;
+
+struct ScriptInstruction {
+    uint8_t op, a, b, c ;                           //registers
+    int32_t imm ;                                   //constant or jump target
+};
+
+class ScriptProgram {
+public:
+    static const int REGISTERS = 16 ;
+    static const int BACKWARD_JUMPS = 1024 ;        //per turn, the turn ends when they run out
+
+    explicit ScriptProgram(std::string_view scriptName) : name(scriptName) {}
+    bool assemble(std::string_view source, std::string& error) ;     //error : "line N: ..."
+    void run(GenericRobot& self) const ;
+    const std::string& getName() const { return name ; }
+    size_t size() const { return code.size() ; }
+
+private:
+    std::string name ;
+    std::vector<ScriptInstruction> code ;           //always ends with OP_HALT
+};
@@ -0,0 +1,160 @@
+#include "SharedState.h"
+#include "BoardFormatter.h"
+
+bool SharedStateExport::open(const std::string& name, uint32_t capacity, const std::vector<uint32_t>& nameIds, bool keep) {
+    close() ;
+    capacity = std::max(capacity, 1u) ;
+
+    std::string names ;
+    for(uint32_t id : nameIds) {
+        const std::string& text = NameTable::name(id) ;
+        uint16_t length = std::min<size_t>(text.size(), UINT16_MAX) ;
+        names.append(reinterpret_cast<const char*>(&id), sizeof(id)) ;
+        names.append(reinterpret_cast<const char*>(&length), sizeof(length)) ;
+        names.append(text, 0, length) ;
+    }
+
+    auto align = [](size_t value) { return (value + 63) & ~size_t(63) ; } ;
+    size_t namesOffset = align(sizeof(SharedStateHeader)) ;
+    size_t frameSize = align(sizeof(SharedStateFrame) + size_t(capacity) * sizeof(RobotRecord)) ;
+    size_t firstFrame = align(namesOffset + names.size()) ;
+    size_t total = firstFrame + 2 * frameSize ;
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644) ;
+    if(fd < 0)
+        return false ;
+    if(ftruncate(fd, total) != 0) {
+        ::close(fd) ;
+        shm_unlink(name.c_str()) ;
+        return false ;
+    }
+    void* mapped = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) ;
+    ::close(fd) ;
+    if(mapped == MAP_FAILED) {
+        shm_unlink(name.c_str()) ;
+        return false ;
+    }
+
+    header = new (mapped) SharedStateHeader() ;            //fresh pages are zero, the atomics start at 0
+    header->version = SHARED_STATE_VERSION ;
+    header->capacity = capacity ;
+    header->namesSize = names.size() ;
+    header->namesOffset = namesOffset ;
+    header->frameOffset[0] = firstFrame ;
+    header->frameOffset[1] = firstFrame + frameSize ;
+    std::memcpy(reinterpret_cast<char*>(header) + namesOffset, names.data(), names.size()) ;
+    for(uint32_t i = 0 ; i < 2 ; i++)
+        new (frameAt(header, i)) SharedStateFrame() ;
+    header->writerAlive.store(1, std::memory_order_relaxed) ;
+    std::atomic_thread_fence(std::memory_order_release) ;
+    std::memcpy(header->magic, "BTLM", 4) ;                 //readers wait for the magic
+
+    segment = name ;
+    keepSegment = keep ;
+    size = total ;
+    return true ;
+}
+
+void SharedStateExport::publish(uint32_t step, int rows, int cols, const std::vector<RobotRecord>& records) {
+    if(!header)
+        return ;
+
+    uint32_t index = 1 - header->latest.load(std::memory_order_relaxed) ;
+    SharedStateFrame* frame = frameAt(header, index) ;
+    uint64_t sequence = frame->sequence.load(std::memory_order_relaxed) ;
+
+    frame->sequence.store(sequence + 1, std::memory_order_relaxed) ;       //odd, frame is being written
+    std::atomic_thread_fence(std::memory_order_release) ;
+    uint32_t count = std::min<size_t>(records.size(), header->capacity) ;
+    frame->step = step ;
+    frame->rows = rows ;
+    frame->cols = cols ;
+    frame->robotCount = count ;
+    std::memcpy(recordsOf(frame), records.data(), count * sizeof(RobotRecord)) ;
+    frame->sequence.store(sequence + 2, std::memory_order_release) ;
+    header->latest.store(index, std::memory_order_release) ;
+}
+
+void SharedStateExport::close() {
+    if(!header)
+        return ;
+    header->writerAlive.store(0, std::memory_order_release) ;
+    munmap(header, size) ;
+    if(!keepSegment)
+        shm_unlink(segment.c_str()) ;
+    header = nullptr ;
+}
+
+bool SharedStateExport::view(const std::string& name, std::ostream& out) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0) ;
+    if(fd < 0)
+        return false ;
+    struct stat info ;
+    if(fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(SharedStateHeader)) {
+        ::close(fd) ;
+        return false ;
+    }
+    size_t total = info.st_size ;
+    void* mapped = mmap(nullptr, total, PROT_READ, MAP_SHARED, fd, 0) ;
+    ::close(fd) ;
+    if(mapped == MAP_FAILED)
+        return false ;
+
+    SharedStateHeader* shared = static_cast<SharedStateHeader*>(mapped) ;
+    auto fits = [total](uint64_t offset, uint64_t bytes) { return offset <= total && bytes <= total - offset ; } ;
+    uint64_t frameBytes = sizeof(SharedStateFrame) + uint64_t(shared->capacity) * sizeof(RobotRecord) ;
+    if(std::memcmp(shared->magic, "BTLM", 4) != 0 || shared->version != SHARED_STATE_VERSION
+       || !fits(shared->namesOffset, shared->namesSize)
+       || !fits(shared->frameOffset[0], frameBytes) || shared->frameOffset[0] % alignof(SharedStateFrame) != 0
+       || !fits(shared->frameOffset[1], frameBytes) || shared->frameOffset[1] % alignof(SharedStateFrame) != 0) {
+        munmap(mapped, total) ;                     //a truncated or foreign segment, nothing in it can be trusted
+        return false ;
+    }
+
+    std::unordered_map<uint32_t, std::string> names ;
+    const char* entry = static_cast<const char*>(mapped) + shared->namesOffset ;
+    const char* namesEnd = entry + shared->namesSize ;
+    while(entry + 6 <= namesEnd) {
+        uint32_t id ;
+        uint16_t length ;
+        std::memcpy(&id, entry, 4) ;
+        std::memcpy(&length, entry + 4, 2) ;
+        names[id] = std::string(entry + 6, std::min<size_t>(length, namesEnd - entry - 6)) ;
+        entry += 6 + length ;
+    }
+
+    BoardFormatter board ;
+    uint32_t step = 0 ;
+    bool consistent = false ;
+    for(int attempt = 0 ; attempt < 1000 && !consistent ; attempt++) {
+        SharedStateFrame* frame = frameAt(shared, shared->latest.load(std::memory_order_acquire) & 1) ;
+        uint64_t before = frame->sequence.load(std::memory_order_acquire) ;
+        if(before & 1)
+            continue ;
+
+        //read straight out of the mapping, nothing is copied until the frame proved consistent
+        step = frame->step ;
+        int rows = std::min<uint32_t>(frame->rows, 4096), cols = std::min<uint32_t>(frame->cols, 4096) ;
+        uint32_t count = std::min(frame->robotCount, shared->capacity) ;
+        board.begin(rows, cols) ;
+        const RobotRecord* records = recordsOf(frame) ;
+        for(uint32_t i = 0 ; i < count ; i++) {
+            const RobotRecord& record = records[i] ;
+            auto found = names.find(record.nameId) ;
+            if((record.flags & RobotRecord::ALIVE) && found != names.end())
+                board.place(record.x, record.y, found->second) ;
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire) ;
+        consistent = frame->sequence.load(std::memory_order_relaxed) == before ;
+    }
+
+    if(consistent) {
+        out << "Step: " << step << (shared->writerAlive.load(std::memory_order_acquire) ? "" : " (writer gone)") << "\n" ;
+        std::string text ;
+        board.write(text) ;
+        out << text ;
+    }
+    munmap(mapped, total) ;
+    return consistent ;
+}
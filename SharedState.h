@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Common.h"
+
+/*POSIX shared memory export of the packed roster. the segment holds a header, the name table and two frames;
+each step is written into the frame readers are not pointed at, under that frame's sequence counter (odd while
+writing), then "latest" flips to it. readers map the segment read only, use the latest frame in place and check
+the sequence did not move while they looked*/
+struct SharedStateHeader {
+    char magic[4] ;                                 //"BTLM"
+    uint32_t version ;
+    uint32_t capacity ;                             //records per frame
+    uint32_t namesSize ;                            //bytes of (u32 id, u16 length, name) entries
+    uint64_t namesOffset ;
+    uint64_t frameOffset[2] ;
+    std::atomic<uint32_t> latest ;                  //frame to read
+    std::atomic<uint32_t> writerAlive ;
+};
+
+struct SharedStateFrame {
+    std::atomic<uint64_t> sequence ;
+    uint32_t step ;
+    uint32_t rows, cols ;
+    uint32_t robotCount ;
+    //RobotRecord records[capacity] follow
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "shared memory frames need address free atomics") ;
+
+const uint32_t SHARED_STATE_VERSION = 2 ;
+
+class SharedStateExport {
+public:
+    ~SharedStateExport() { close() ; }
+    bool open(const std::string& name, uint32_t capacity, const std::vector<uint32_t>& nameIds, bool keep) ;
+    bool isOpen() const { return header != nullptr ; }
+    void publish(uint32_t step, int rows, int cols, const std::vector<RobotRecord>& records) ;
+    void close() ;
+
+    static bool view(const std::string& name, std::ostream& out) ;     //print the latest consistent frame
+
+private:
+    std::string segment ;
+    bool keepSegment = false ;
+    SharedStateHeader* header = nullptr ;
+    size_t size = 0 ;
+
+    static SharedStateFrame* frameAt(SharedStateHeader* header, uint32_t index) {
+        return reinterpret_cast<SharedStateFrame*>(reinterpret_cast<char*>(header) + header->frameOffset[index]) ;
+    }
+    static RobotRecord* recordsOf(SharedStateFrame* frame) { return reinterpret_cast<RobotRecord*>(frame + 1) ; }
+};
@@ -0,0 +1,157 @@
+#include "SpatialIndex.h"
+#include "Battlefield.h"
+
+void SpatialIndex::reset(int cols, int rows) {
+    bucketCols = std::max(1, (cols + BUCKET - 1) / BUCKET) ;
+    bucketRows = std::max(1, (rows + BUCKET - 1) / BUCKET) ;
+    buckets.resize(size_t(bucketCols) * bucketRows) ;
+    for(std::vector<Robot*>& list : buckets)
+        list.clear() ;                              //a warm battlefield's next match keeps the bucket capacity
+}
+
+int SpatialIndex::bucketOf(int x, int y) const {         //anything off the board is clamped into an edge bucket
+    int bx = std::max(0, std::min(bucketCols - 1, x / BUCKET)) ;
+    int by = std::max(0, std::min(bucketRows - 1, y / BUCKET)) ;
+    return by * bucketCols + bx ;
+}
+
+bool SpatialIndex::eraseFrom(int bucket, Robot* robot) {
+    std::vector<Robot*>& list = buckets[bucket] ;
+    for(size_t i = 0 ; i < list.size() ; i++) {
+        if(list[i] == robot) {
+            list[i] = list.back() ;
+            list.pop_back() ;
+            return true ;
+        }
+    }
+    return false ;
+}
+
+void SpatialIndex::insert(Robot* robot) {
+    buckets[bucketOf(robot->getX(), robot->getY())].push_back(robot) ;
+}
+
+void SpatialIndex::sortBuckets() {
+    for(std::vector<Robot*>& bucket : buckets)
+        std::sort(bucket.begin(), bucket.end(), [](const Robot* a, const Robot* b) {
+            uint32_t first = mortonIndex(a->getX(), a->getY()), second = mortonIndex(b->getX(), b->getY()) ;
+            return first != second ? first < second : a->getNameId() < b->getNameId() ;
+        }) ;
+}
+
+void SpatialIndex::erase(Robot* robot) {
+    eraseFrom(bucketOf(robot->getX(), robot->getY()), robot) ;
+}
+
+void SpatialIndex::move(Robot* robot, int oldX, int oldY) {
+    int from = bucketOf(oldX, oldY) ;
+    int to = bucketOf(robot->getX(), robot->getY()) ;
+    if(from != to && eraseFrom(from, robot))                 //robots not on the roster yet are not indexed
+        buckets[to].push_back(robot) ;
+}
+
+Robot* SpatialIndex::robotAt(int x, int y, const RobotSlots& roster, int team) const {
+    //robots can share a cell, and bucket order is not roster order (moves, Morton sorts), so pick by roster position
+    Robot* found = nullptr ;
+    for(Robot* robot : buckets[bucketOf(x, y)]) {
+        if(robot->isAlive() && robot->getX() == x && robot->getY() == y && (team == 0 || robot->getTeam() != team)
+           && (!found || roster.position(robot->getHandle()) < roster.position(found->getHandle())))
+            found = robot ;
+    }
+    return found ;
+}
+
+Robot* SpatialIndex::nearest(int x, int y, const Robot* exclude, int team, int maxRange) const {
+    Robot* best = nullptr ;
+    int bestDistance = INT32_MAX ;
+    int bx = std::max(0, std::min(bucketCols - 1, x / BUCKET)) ;
+    int by = std::max(0, std::min(bucketRows - 1, y / BUCKET)) ;
+    int maxRing = std::max(bucketCols, bucketRows) ;
+
+    for(int ring = 0 ; ring <= maxRing ; ring++) {
+        for(int cy = by - ring ; cy <= by + ring ; cy++) {
+            if(cy < 0 || cy >= bucketRows)
+                continue ;
+            bool edgeRow = cy == by - ring || cy == by + ring ;
+            for(int cx = bx - ring ; cx <= bx + ring ; cx += edgeRow ? 1 : 2 * ring) {   //only the ring's border
+                if(cx >= 0 && cx < bucketCols) {
+                    for(Robot* robot : buckets[cy * bucketCols + cx]) {
+                        if(robot == exclude || !robot->isAlive() || (team != 0 && robot->getTeam() == team))
+                            continue ;
+                        int distance = std::max(std::abs(robot->getX() - x), std::abs(robot->getY() - y)) ;
+                        if(distance > maxRange)
+                            continue ;
+                        if(distance < bestDistance || (distance == bestDistance && robot->getNameId() < best->getNameId())) {
+                            best = robot ;
+                            bestDistance = distance ;
+                        }
+                    }
+                }
+                if(ring == 0)
+                    break ;
+            }
+        }
+        //every bucket outside this ring is more than ring * BUCKET cells away
+        if(bestDistance <= ring * BUCKET || ring * BUCKET >= maxRange)
+            break ;
+    }
+    return best ;
+}
+
+void SpatialIndex::withinRange(int x, int y, int range, const Robot* exclude, std::vector<Robot*>& out) const {
+    out.clear() ;
+    int x0 = std::max(0, (x - range) / BUCKET), x1 = std::min(bucketCols - 1, std::max(0, x + range) / BUCKET) ;
+    int y0 = std::max(0, (y - range) / BUCKET), y1 = std::min(bucketRows - 1, std::max(0, y + range) / BUCKET) ;
+    for(int cy = y0 ; cy <= y1 ; cy++) {
+        for(int cx = x0 ; cx <= x1 ; cx++) {
+            for(Robot* robot : buckets[cy * bucketCols + cx]) {
+                if(robot != exclude && robot->isAlive()
+                   && std::abs(robot->getX() - x) <= range && std::abs(robot->getY() - y) <= range)
+                    out.push_back(robot) ;
+            }
+        }
+    }
+}
+
+int SpatialIndex::countWithin(int x, int y, int range, const Robot* exclude, int team) const {
+    int count = 0 ;
+    int x0 = std::max(0, (x - range) / BUCKET), x1 = std::min(bucketCols - 1, std::max(0, x + range) / BUCKET) ;
+    int y0 = std::max(0, (y - range) / BUCKET), y1 = std::min(bucketRows - 1, std::max(0, y + range) / BUCKET) ;
+    for(int cy = y0 ; cy <= y1 ; cy++) {
+        for(int cx = x0 ; cx <= x1 ; cx++) {
+            for(const Robot* robot : buckets[cy * bucketCols + cx]) {
+                if(robot != exclude && robot->isAlive() && (team == 0 || robot->getTeam() != team)
+                   && std::abs(robot->getX() - x) <= range && std::abs(robot->getY() - y) <= range)
+                    count++ ;
+            }
+        }
+    }
+    return count ;
+}
+
+void SpatialIndex::nearest(int x, int y, const Robot* exclude, size_t k, std::vector<Robot*>& out) const {
+    out.clear() ;
+    if(k == 0)
+        return ;
+
+    auto closer = [x, y](const Robot* a, const Robot* b) {
+        int da = std::max(std::abs(a->getX() - x), std::abs(a->getY() - y)) ;
+        int db = std::max(std::abs(b->getX() - x), std::abs(b->getY() - y)) ;
+        return da != db ? da < db : a->getNameId() < b->getNameId() ;
+    };
+
+    //grow the square until it holds k robots, every robot closer than the k-th is then inside it
+    int limit = std::max(bucketCols, bucketRows) * BUCKET ;
+    for(int range = BUCKET ; ; range *= 2) {
+        withinRange(x, y, range, exclude, out) ;
+        if(out.size() >= k || range >= limit)
+            break ;
+    }
+    if(out.size() > k) {
+        std::partial_sort(out.begin(), out.begin() + k, out.end(), closer) ;
+        out.resize(k) ;
+    }
+    else {
+        std::sort(out.begin(), out.end(), closer) ;
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Common.h"
+
+inline uint32_t spreadBits(uint32_t value) {       //low 16 bits moved to the even bit positions
+    value &= 0xFFFF ;
+    value = (value | value << 8) & 0x00FF00FF ;
+    value = (value | value << 4) & 0x0F0F0F0F ;
+    value = (value | value << 2) & 0x33333333 ;
+    return (value | value << 1) & 0x55555555 ;
+}
+
+inline uint32_t mortonIndex(int x, int y) {        //Z-order position, cells close on the board get close indexes
+    return spreadBits(x) | spreadBits(y) << 1 ;
+}
+
+/*uniform grid buckets over the board, BUCKET x BUCKET cells each, holding every robot on the roster (dead ones too,
+queries skip them). kept up to date by createRobot, removeRobot and Robot::setPosition, so a cell lookup reads one
+small bucket and nearest() only walks rings of buckets until nothing closer can remain*/
+class SpatialIndex {
+public:
+    static const int BUCKET = 8 ;
+
+    void reset(int cols, int rows) ;
+    void insert(Robot* robot) ;
+    void erase(Robot* robot) ;
+    void move(Robot* robot, int oldX, int oldY) ;
+
+    Robot* robotAt(int x, int y, const RobotSlots& roster, int team = 0) const ;    //live robot on that cell earliest in the roster, skips team mates
+    Robot* nearest(int x, int y, const Robot* exclude, int team = 0, int maxRange = INT32_MAX) const ;    //Chebyshev distance, ties by name id, skips team mates
+    void nearest(int x, int y, const Robot* exclude, size_t k, std::vector<Robot*>& out) const ;    //k closest, nearest first
+    void withinRange(int x, int y, int range, const Robot* exclude, std::vector<Robot*>& out) const ;
+    int countWithin(int x, int y, int range, const Robot* exclude, int team = 0) const ;     //live robots, team mates skipped
+    void sortBuckets() ;                                                //Morton order inside every bucket
+
+private:
+    int bucketCols = 0, bucketRows = 0 ;
+    std::vector<std::vector<Robot*>> buckets ;
+
+    int bucketOf(int x, int y) const ;
+    bool eraseFrom(int bucket, Robot* robot) ;
+};
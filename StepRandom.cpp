@@ -0,0 +1,23 @@
+#include "StepRandom.h"
+
+uint32_t StepRandom::stepKey(uint64_t step) const {
+    uint64_t z = seed + (step + 1) * 0x9E3779B97F4A7C15ull ;        //splitmix64 finaliser
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull ;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull ;
+    return static_cast<uint32_t>(z ^ (z >> 31)) ;
+}
+
+void StepRandom::generate(uint64_t step, size_t robots) {
+    draws.resize(robots * ROLLS_PER_ROBOT) ;
+
+    const uint32_t key = stepKey(step) ;
+    overflowKey = hash(key ^ 0x68E31DA4u) ;
+    int32_t* out = draws.data() ;
+    const uint32_t count = draws.size() ;
+    for(uint32_t i = 0 ; i < count ; i++)                 //no loop carried state
+        out[i] = hash(i * 0x9E3779B9u + key) >> 1 ;
+}
+
+int StepRandom::overflow(uint32_t stream, uint32_t index) const {
+    return hash(hash(stream * 0x9E3779B9u + overflowKey) + index * 0x85EBCA6Bu) >> 1 ;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Common.h"
+
+class StepRandom {                                  //per step random draws for every robot, generated in one pass
+public:
+    static const int ROLLS_PER_ROBOT = 16 ;         //a turn normally needs 6 to 11
+
+    void seedWith(uint64_t value) { seed = value ; }
+    void generate(uint64_t step, size_t robots) ;
+    int at(size_t slot, int index) const { return draws[slot * ROLLS_PER_ROBOT + index] ; }
+    int overflow(uint32_t stream, uint32_t index) const ;   //draws past a robot's slots, one stream per robot
+
+private:
+    uint64_t seed = 0 ;
+    uint32_t overflowKey = 0 ;                      //this step's, apart from the slot draws' key
+    std::vector<int32_t> draws ;
+
+    static uint32_t hash(uint32_t x) {            //lowbias32, only 32 bit multiplies so the loop vectorizes
+        x ^= x >> 16 ;
+        x *= 0x7feb352du ;
+        x ^= x >> 15 ;
+        x *= 0x846ca68bu ;
+        x ^= x >> 16 ;
+        return x ;
+    }
+    uint32_t stepKey(uint64_t step) const ;
+};
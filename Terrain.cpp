@@ -0,0 +1,45 @@
+#include "Terrain.h"
+
+void Terrain::reset(int c, int r) {
+    cols = c ;
+    rows = r ;
+    size_t words = (size_t(cols) * rows + 63) / 64 ;
+    walls.assign(words, 0) ;
+    cover.assign(words, 0) ;
+    slow.assign(words, 0) ;
+    any = false ;
+}
+
+void Terrain::set(int x, int y, TerrainType type) {
+    if(x < 0 || y < 0 || x >= cols || y >= rows)
+        return ;
+    size_t bit = size_t(y) * cols + x ;
+    uint64_t mask = 1ull << (bit & 63) ;
+    walls[bit >> 6] &= ~mask ;
+    cover[bit >> 6] &= ~mask ;
+    slow[bit >> 6] &= ~mask ;
+    if(type == TERRAIN_WALL)
+        walls[bit >> 6] |= mask ;
+    else if(type == TERRAIN_COVER)
+        cover[bit >> 6] |= mask ;
+    else if(type == TERRAIN_SLOW)
+        slow[bit >> 6] |= mask ;
+    any = any || type != TERRAIN_OPEN ;
+}
+
+TerrainType Terrain::at(int x, int y) const {
+    if(isWall(x, y))
+        return TERRAIN_WALL ;
+    if(isCover(x, y))
+        return TERRAIN_COVER ;
+    return isSlow(x, y) ? TERRAIN_SLOW : TERRAIN_OPEN ;
+}
+
+TerrainType Terrain::fromChar(char c) {
+    switch(c) {
+        case '#' : return TERRAIN_WALL ;
+        case '%' : return TERRAIN_COVER ;
+        case '~' : return TERRAIN_SLOW ;
+        default : return TERRAIN_OPEN ;
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Common.h"
+
+enum TerrainType : uint8_t {
+    TERRAIN_OPEN,                                   //'.'
+    TERRAIN_WALL,                                   //'#' nothing enters, shots stop
+    TERRAIN_COVER,                                  //'%' shots cannot pass over it, robots in it only take adjacent shots
+    TERRAIN_SLOW                                    //'~' leaving it takes two turns, charges stop on it
+} ;
+
+class Terrain {                                     //one bitplane per terrain type, a bit per cell in row major order
+public:
+    void reset(int cols, int rows) ;
+    void set(int x, int y, TerrainType type) ;
+    TerrainType at(int x, int y) const ;
+    bool isWall(int x, int y) const { return test(walls, x, y) ; }
+    bool isCover(int x, int y) const { return test(cover, x, y) ; }
+    bool isSlow(int x, int y) const { return test(slow, x, y) ; }
+    bool empty() const { return !any ; }
+    static TerrainType fromChar(char c) ;
+
+private:
+    int cols = 0, rows = 0 ;
+    bool any = false ;
+    std::vector<uint64_t> walls, cover, slow ;
+
+    bool test(const std::vector<uint64_t>& plane, int x, int y) const {
+        if(x < 0 || y < 0 || x >= cols || y >= rows)
+            return false ;
+        size_t bit = size_t(y) * cols + x ;
+        return plane[bit >> 6] >> (bit & 63) & 1 ;
+    }
+};
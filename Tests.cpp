@@ -0,0 +1,1120 @@
+#include "Battlefield.h"
+#include "MatchService.h"
+
+/*unit checks of behaviour a normal run's output would not show, built and run by `make test`. one line per check,
+exit code 1 if any failed. matches run on a console-only logger that is switched off, so log.txt is left alone*/
+
+static std::string header(int size, int robots, int steps = 5) {      //square board, then the steps and robots lines
+    std::string text = "M by N : " + std::to_string(size) + " " + std::to_string(size) + "\n" ;
+    return text + "steps: " + std::to_string(steps) + "\nrobots: " + std::to_string(robots) + "\n" ;
+}
+
+static std::unique_ptr<Battlefield> quietBattlefield() {
+    std::unique_ptr<Battlefield> battlefield(new Battlefield(MAX_ROWS, MAX_COLS, new Logger(""))) ;
+    battlefield->getLogger()->setEnabled(false) ;
+    return battlefield ;
+}
+
+static std::unique_ptr<Battlefield> quietBattlefield(std::string_view scenario) {
+    std::unique_ptr<Battlefield> battlefield = quietBattlefield() ;
+    battlefield->loadFromText(scenario) ;
+    return battlefield ;
+}
+
+static Robot* findRobot(Battlefield& battlefield, std::string_view name) {
+    for(Robot* robot : battlefield.getRobots())
+        if(robot->getName() == name)
+            return robot ;
+    return nullptr ;
+}
+
+static std::string tempPath(const std::string& name) {     //per process, so parallel runs do not share files
+    return "/tmp/full_tests_" + std::to_string(getpid()) + "_" + name ;
+}
+
+static bool writeFile(const std::string& path, const std::string& text) {
+    std::ofstream out(path, std::ios::out | std::ios::trunc | std::ios::binary) ;
+    out << text ;
+    return static_cast<bool>(out) ;
+}
+
+static std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::in | std::ios::binary) ;
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()) ;
+}
+
+static bool checkStreamedLinesMatchText() {        //lines split across tiny blocks parse like the whole text, errors only on bad lines
+    std::string text = header(20, 3) + "GenericRobot Alpha 2 3\r\nGenericRobot Beta random 7 team=2\nGenericRobot Gamma 1 x\n" ;
+    std::string path = tempPath("stream.txt") ;
+    if(!writeFile(path, text))
+        return false ;
+    ScenarioReader streamed(path, 8) ;
+    ScenarioReader whole = ScenarioReader::fromText(text) ;
+    ScenarioReader::Line a, b ;
+    std::vector<ScenarioReader::LineKind> kinds ;
+    bool same = true ;
+    while(streamed.next(a)) {
+        same = same && whole.next(b) && a.kind == b.kind && a.name == b.name && a.type == b.type && a.x == b.x && a.y == b.y &&
+               a.randomX == b.randomX && a.team == b.team && std::string_view(a.error) == b.error ;
+        same = same && (a.kind == ScenarioReader::INVALID) == (*a.error != 0) ;
+        if(a.kind == ScenarioReader::ROBOT && a.name == "Beta")
+            same = same && a.randomX && !a.randomY && a.y == 7 && a.team == 2 ;
+        kinds.push_back(a.kind) ;
+    }
+    std::remove(path.c_str()) ;
+    std::vector<ScenarioReader::LineKind> expected = {ScenarioReader::SIZE, ScenarioReader::STEPS, ScenarioReader::ROBOTS,
+                                                      ScenarioReader::ROBOT, ScenarioReader::ROBOT, ScenarioReader::INVALID} ;
+    return same && !whole.next(b) && kinds == expected ;
+}
+
+static bool checkBadCountsRejected() {             //negative or absurd sizes and counts fail the load before anything is reserved
+    const char* scenarios[] = {
+        "M by N : -5 10\nsteps: 5\nrobots: 0\n",
+        "M by N : 10 0\nsteps: 5\nrobots: 0\n",
+        "M by N : 10 100000\nsteps: 5\nrobots: 0\n",
+        "M by N : 10 10\nsteps: -1\nrobots: 0\n",
+        "M by N : 10 10\nsteps: 5\nrobots: -1\n",
+        "M by N : 10 10\nsteps: 5\nrobots: 2000000000\n",
+        "M by N : 10 10\nsteps: 5\nrobots: 1\nGenericRobot Abc 3x 4\n",
+    } ;
+    for(const char* scenario : scenarios) {
+        if(quietBattlefield()->loadFromText(scenario))
+            return false ;
+    }
+    return true ;
+}
+
+static bool checkBinaryScenarioRoundTrip() {       //--compile settles every cell from the seed, loading gives the same robots back
+    std::string text = tempPath("scenario.txt"), first = tempPath("first.bin"), second = tempPath("second.bin") ;
+    writeFile(text, header(6, 4) + "GenericRobot Kidd 1 2 team=3\nGenericRobot Jet random random\nGenericRobot Ace 1 2\nGenericRobot Bo 9 4\n") ;
+    bool compiled = Battlefield::compileScenario(text, first, 11) && Battlefield::compileScenario(text, second, 11) ;
+    bool repeatable = compiled && readFile(first) == readFile(second) ;
+
+    auto battlefield = quietBattlefield() ;
+    bool loaded = compiled && battlefield->loadFromBinary(first) && battlefield->getRows() == 6 && battlefield->getRobots().size() == 4 ;
+    std::vector<bool> taken(36, false) ;
+    bool placed = loaded ;
+    for(Robot* robot : battlefield->getRobots()) {
+        placed = placed && battlefield->isInside(robot->getX(), robot->getY()) && !taken[robot->getY() * 6 + robot->getX()] ;
+        if(placed)
+            taken[robot->getY() * 6 + robot->getX()] = true ;
+    }
+    Robot* kidd = findRobot(*battlefield, "Kidd") ;
+    placed = placed && kidd && kidd->getX() == 1 && kidd->getY() == 2 && kidd->getTeam() == 3 && kidd->getKind() == RobotKind::GenericRobot ;
+
+    std::string bytes = readFile(first) ;              //a table cut short is refused, not read past
+    writeFile(second, bytes.substr(0, bytes.size() - 3)) ;
+    bool truncatedRefused = !quietBattlefield()->loadFromBinary(second) ;
+    for(const std::string& path : {text, first, second})
+        std::remove(path.c_str()) ;
+    return repeatable && placed && truncatedRefused ;
+}
+
+static bool checkLatencyPercentiles() {            //log-linear buckets : small values exact, larger ones within one sub-bucket
+    LatencyHistogram histogram ;
+    for(uint64_t value = 1 ; value <= 1000 ; value++)
+        histogram.record(value) ;
+    auto near = [](uint64_t got, uint64_t want) { return got <= want && got * 16 >= want * 15 ; } ;
+    LatencyHistogram small ;
+    small.record(3) ;
+    return histogram.getCount() == 1000 && histogram.getMax() == 1000 && histogram.getTotal() == 500500 &&
+           near(histogram.percentile(0.50), 500) && near(histogram.percentile(0.99), 990) && histogram.percentile(1.0) <= 1000 &&
+           small.percentile(0.50) == 3 && LatencyHistogram().percentile(0.99) == 0 ;
+}
+
+static bool checkStepMetricsFollowTheRun() {       //each phase is timed once per step, action counts match what robots did
+    auto battlefield = quietBattlefield(header(10, 3, 20) + "GenericRobot Alpha 1 1\nGenericRobot Beta 5 5\nGenericRobot Gamma 8 2\n") ;
+    std::string path = tempPath("metrics.csv") ;
+    battlefield->getMetrics().enable(path, 0) ;
+    battlefield->setKindStats(true) ;
+    srand(5) ;
+    int ran = battlefield->advance(20) ;
+    bool written = battlefield->getMetrics().write() ;
+    std::string csv = readFile(path) ;
+    std::remove(path.c_str()) ;
+
+    uint32_t moves = 0 ;
+    for(int kind = 0 ; kind < int(RobotKind::COUNT) ; kind++)
+        moves += battlefield->getKindActions(RobotKind(kind))[ACTION_MOVE] ;
+    bool phases = true ;
+    for(int phase = 0 ; phase < PHASE_COUNT ; phase++)
+        phases = phases && csv.find("phase," + std::string(StepMetrics::phaseName(StepPhase(phase))) + "," + std::to_string(ran) + ",") != std::string::npos ;
+    return written && ran > 0 && phases && moves > 0 && csv.find("action,moves," + std::to_string(moves) + ",") != std::string::npos ;
+}
+
+static bool checkPerfCountersOrFallback() {        //--perf : per phase and per type counters when allowed, plain timings otherwise
+    PerfSample total, before, after ;
+    before.values[PERF_CYCLES] = 10 ;
+    after.values[PERF_CYCLES] = 25 ;
+    total.add(before, after) ;
+    total.add(before, after) ;
+    bool adds = total.values[PERF_CYCLES] == 30 && total.values[PERF_INSTRUCTIONS] == 0 ;
+
+    auto battlefield = quietBattlefield(header(10, 2, 10) + "GenericRobot Alpha 1 1\nGenericRobot Beta 8 8\n") ;
+    std::string path = tempPath("perf.csv") ;
+    battlefield->getMetrics().enable(path, 0) ;
+    bool counting = battlefield->getMetrics().enablePerf() ;
+    srand(5) ;
+    battlefield->advance(10) ;
+    battlefield->getMetrics().write() ;
+    std::string csv = readFile(path) ;
+    std::remove(path.c_str()) ;
+    if(!counting)                                   //no counter access here (container, paranoid kernel) : nothing reported
+        return adds && csv.find("phase,turns,") != std::string::npos && csv.find("perf_") == std::string::npos ;
+    return adds && csv.find("perf_phase,turns,") != std::string::npos && csv.find("perf_type,GenericRobot,") != std::string::npos ;
+}
+
+static bool checkNamesInternedOnce() {             //a name gets one id whichever thread interns it, and the id gives the name back
+    std::vector<uint32_t> shared(4) ;
+    std::vector<std::thread> threads ;
+    for(int t = 0 ; t < 4 ; t++) {
+        threads.emplace_back([t, &shared]() {
+            for(int i = 0 ; i < 500 ; i++)
+                NameTable::intern("Racer" + std::to_string(t) + "_" + std::to_string(i)) ;
+            shared[t] = NameTable::intern("SharedName") ;
+        }) ;
+    }
+    for(std::thread& thread : threads)
+        thread.join() ;
+    uint32_t a = NameTable::intern("Racer1_7"), b = NameTable::intern("Racer2_7") ;
+    return shared[0] == shared[1] && shared[1] == shared[2] && shared[2] == shared[3] && NameTable::name(shared[0]) == "SharedName" &&
+           a != b && NameTable::name(a) == "Racer1_7" && NameTable::intern("Racer1_7") == a ;
+}
+
+static bool checkRobotRecordPacksState() {         //the export record carries every hot field and the robot's roster slot
+    auto battlefield = quietBattlefield(header(10, 2) + "GenericRobot Alpha 3 4 team=2\nGenericRobot Beta 7 7\n") ;
+    Robot* alpha = findRobot(*battlefield, "Alpha") ;
+    alpha->setLives(2) ;
+    alpha->setUpgradeSecond(true) ;
+    findRobot(*battlefield, "Beta")->kill() ;
+    std::vector<RobotRecord> records ;
+    battlefield->packRecords(records) ;
+    if(records.size() != 2)
+        return false ;
+    const RobotRecord& record = records[0].nameId == alpha->getNameId() ? records[0] : records[1] ;
+    const RobotRecord& dead = &record == &records[0] ? records[1] : records[0] ;
+    return record.x == 3 && record.y == 4 && record.kind == RobotKind::GenericRobot && record.lives == 2 &&
+           record.flags == (RobotRecord::ALIVE | RobotRecord::UPGRADE_SECOND) && record.slot == alpha->getHandle().index &&
+           record.shells == dynamic_cast<ShootingRobot*>(alpha)->getShells() && !(dead.flags & RobotRecord::ALIVE) && dead.slot != record.slot ;
+}
+
+static bool checkTypedDispatchMatchesRoster() {    //one kind keeps roster order, so the batch path must end in the same state
+    std::string scenario = header(30, 4, 4) + "GenericRobot Alpha 3 3\nGenericRobot Beta 20 3\nGenericRobot Gamma 3 20\nGenericRobot Delta 20 20\n" ;
+    uint64_t hashes[2] ;
+    for(int i = 0 ; i < 2 ; i++) {
+        auto battlefield = quietBattlefield(scenario) ;
+        battlefield->setDispatchMode(i == 0 ? DISPATCH_ROSTER : DISPATCH_BY_TYPE) ;
+        srand(21) ;
+        battlefield->advance(4) ;                       //too far apart to kill, so nobody upgrades into a second kind
+        hashes[i] = battlefield->getStateHash() ;
+    }
+    return hashes[0] == hashes[1] ;
+}
+
+static bool checkTypedDispatchRunsEveryKind() {    //with mixed kinds every live robot still gets exactly one turn a step
+    auto battlefield = quietBattlefield(header(30, 4, 2) + "GenericRobot Alpha 5 5\nGenericRobot Beta 15 5\nGenericRobot Gamma 5 15\nGenericRobot Delta 15 15\n") ;
+    battlefield->setDispatchMode(DISPATCH_BY_TYPE) ;
+    battlefield->setKindStats(true) ;
+    srand(3) ;
+    findRobot(*battlefield, "Alpha")->setUpgradePoints(1) ;     //upgraded at the end of the first step
+    findRobot(*battlefield, "Gamma")->setUpgradePoints(1) ;
+    battlefield->advance(1) ;
+    uint32_t before[size_t(RobotKind::COUNT)] ;
+    for(int kind = 0 ; kind < int(RobotKind::COUNT) ; kind++)
+        before[kind] = battlefield->getKindActions(RobotKind(kind))[ACTION_LOOK] ;
+    battlefield->advance(1) ;                           //robots far apart, so all four look inside the board and none is shot first
+    uint32_t looks = 0 ;
+    int kinds = 0 ;
+    for(int kind = 0 ; kind < int(RobotKind::COUNT) ; kind++) {
+        uint32_t added = battlefield->getKindActions(RobotKind(kind))[ACTION_LOOK] - before[kind] ;
+        looks += added ;
+        kinds += added > 0 ;
+    }
+    return battlefield->getRobots().size() == 4 && looks == 4 && kinds >= 2 ;
+}
+
+static bool checkPolicyRobotsMatchClasses() {      //--robots=policy builds every kind with the same type, kind and starting state
+    auto battlefield = quietBattlefield(header(10, 0)) ;
+    bool same = true ;
+    for(int kind = 0 ; kind < int(RobotKind::COUNT) ; kind++) {
+        battlefield->setRobotModel(MODEL_CLASSES) ;
+        std::unique_ptr<Robot> written(battlefield->buildRobot(RobotKind(kind), "Twin", 2, 3)) ;
+        battlefield->setRobotModel(MODEL_POLICY) ;
+        std::unique_ptr<Robot> composed(battlefield->buildRobot(RobotKind(kind), "Twin", 2, 3)) ;
+        same = same && written && composed && composed->getKind() == RobotKind(kind) && composed->getType() == written->getType() &&
+               composed->stateHash() == written->stateHash() && typeid(*composed) != typeid(*written) ;
+    }
+    return same ;
+}
+
+static bool checkPolicyMatchPlaysTheSame() {       //composed abilities draw and act like the hand written classes, upgrades included
+    std::string scenario = header(8, 5, 40) + "GenericRobot Alpha 1 1\nGenericRobot Beta 3 2\nGenericRobot Gamma 6 6\nGenericRobot Delta 2 5\nGenericRobot Echo 5 3\n" ;
+    uint64_t hashes[2] ;
+    bool upgraded = false ;
+    for(int i = 0 ; i < 2 ; i++) {
+        auto battlefield = quietBattlefield() ;
+        battlefield->setRobotModel(i == 0 ? MODEL_CLASSES : MODEL_POLICY) ;
+        battlefield->loadFromText(scenario) ;
+        srand(8) ;
+        battlefield->advance(40) ;
+        hashes[i] = battlefield->getStateHash() ;
+        for(Robot* robot : battlefield->getRobots())
+            upgraded = upgraded || robot->getKind() != RobotKind::GenericRobot ;
+    }
+    return upgraded && hashes[0] == hashes[1] ;
+}
+
+static bool checkBulkRollsIgnoreTurnOrder() {      //--bulk-rng : a robot's draws, overflow included, do not depend on who rolled first
+    auto battlefield = quietBattlefield(header(20, 2) + "GenericRobot Alpha 2 2\nGenericRobot Beta 9 9\n") ;
+    battlefield->setBulkRandom(true) ;
+    battlefield->advance(1) ;                       //generates the step's draws
+    Robot* robots[] = {findRobot(*battlefield, "Alpha"), findRobot(*battlefield, "Beta")} ;
+    std::vector<int> draws[2][2] ;                  //[order][robot]
+    for(int order = 0 ; order < 2 ; order++) {
+        robots[0]->setRollSlot(0) ;
+        robots[1]->setRollSlot(1) ;
+        for(int i = 0 ; i < 2 ; i++) {
+            int who = order == 0 ? i : 1 - i ;
+            for(int n = 0 ; n < 3 * StepRandom::ROLLS_PER_ROBOT ; n++)
+                draws[order][who].push_back(robots[who]->roll()) ;
+        }
+    }
+    return draws[0][0] == draws[1][0] && draws[0][1] == draws[1][1] && draws[0][0] != draws[0][1] ;
+}
+
+static bool checkStepDrawsRepeatable() {           //a step's draws depend on seed, step and slot only, and split evenly over % 3
+    StepRandom small, large, later ;
+    for(StepRandom* random : {&small, &large, &later})
+        random->seedWith(77) ;
+    small.generate(4, 10) ;
+    large.generate(4, 1000) ;
+    later.generate(5, 10) ;
+    bool same = true, moved = false ;
+    for(int slot = 0 ; slot < 10 ; slot++) {
+        for(int i = 0 ; i < StepRandom::ROLLS_PER_ROBOT ; i++) {
+            same = same && small.at(slot, i) == large.at(slot, i) && small.at(slot, i) >= 0 ;
+            moved = moved || small.at(slot, i) != later.at(slot, i) ;
+        }
+        same = same && small.overflow(slot, 3) == large.overflow(slot, 3) ;
+    }
+    int thirds[3] = {} ;
+    for(int slot = 0 ; slot < 1000 ; slot++)
+        for(int i = 0 ; i < StepRandom::ROLLS_PER_ROBOT ; i++)
+            thirds[large.at(slot, i) % 3]++ ;
+    bool even = true ;
+    for(int count : thirds)
+        even = even && count > 16000 / 3 * 9 / 10 && count < 16000 / 3 * 11 / 10 ;
+    return same && moved && even ;
+}
+
+static bool checkBulkMatchRepeatable() {           //--bulk-rng seeds from rand(), so one srand gives one match
+    std::string scenario = header(8, 4, 25) + "GenericRobot Alpha 1 1\nGenericRobot Beta 3 2\nGenericRobot Gamma 6 6\nGenericRobot Delta 2 5\n" ;
+    uint64_t hashes[2] ;
+    for(uint64_t& hash : hashes) {
+        auto battlefield = quietBattlefield(scenario) ;
+        srand(13) ;
+        battlefield->setBulkRandom(true) ;
+        battlefield->advance(25) ;
+        hash = battlefield->getStateHash() ;
+    }
+    return hashes[0] == hashes[1] ;
+}
+
+static std::string replayLines(Battlefield& battlefield) {     //what ReplayReader::display lists under the board, in slot order
+    std::vector<RobotRecord> records ;
+    battlefield.packRecords(records) ;
+    std::sort(records.begin(), records.end(), [](const RobotRecord& a, const RobotRecord& b) { return a.slot < b.slot ; }) ;
+    std::string lines ;
+    for(const RobotRecord& record : records) {
+        lines += NameTable::name(record.nameId) + " " + robotKindName(record.kind) + " (" + std::to_string(record.x) + "," +
+                 std::to_string(record.y) + ")" + (record.flags & RobotRecord::ALIVE ? "" : " dead") + "\n" ;
+    }
+    return lines ;
+}
+
+static bool checkReplaySeeksToEveryStep() {        //--replay : any step, before or after a keyframe, comes back as it was played
+    std::string path = tempPath("replay.bin") ;
+    std::vector<std::string> expected ;
+    {
+        auto battlefield = quietBattlefield(header(8, 5, 30) + "GenericRobot Alpha 1 1\nGenericRobot Beta 3 2\nGenericRobot Gamma 6 6\nGenericRobot Delta 2 5\nGenericRobot Echo 5 3\n") ;
+        if(!battlefield->startReplay(path, 4))
+            return false ;
+        srand(17) ;
+        while(battlefield->advance(1) == 1)
+            expected.push_back(replayLines(*battlefield)) ;
+    }                                                   //the writer closes with the battlefield
+
+    ReplayReader reader ;
+    bool same = reader.open(path) && reader.getLastStep() == int(expected.size()) ;
+    for(int step : {int(expected.size()), 1, 5, 4, 9, 2}) {
+        std::ostringstream out ;
+        same = same && step <= int(expected.size()) && reader.seek(step) ;
+        reader.display(out) ;
+        std::string text = out.str(), lines = expected[step - 1] ;
+        same = same && text.rfind("Step: " + std::to_string(step) + "\n", 0) == 0 && text.size() >= lines.size() &&
+               text.compare(text.size() - lines.size(), lines.size(), lines) == 0 ;
+    }
+
+    std::string bytes = readFile(path) ;                //a file cut short is refused, not read past
+    writeFile(path, bytes.substr(0, bytes.size() / 2)) ;
+    ReplayReader cut ;
+    bool refused = !cut.open(path) || !cut.seek(cut.getLastStep()) ;
+    std::remove(path.c_str()) ;
+    return same && expected.size() > 9 && refused ;
+}
+
+static bool checkSpatialQueriesMatchScan() {       //bucket walks give what a scan of the whole roster gives, after robots moved
+    std::string scenario = header(60, 40, 50) ;
+    for(int i = 0 ; i < 40 ; i++)
+        scenario += "GenericRobot R" + std::to_string(i) + " random random" + (i % 3 ? " team=" + std::to_string(i % 3) : "") + "\n" ;
+    srand(29) ;
+    auto battlefield = quietBattlefield(scenario) ;
+    battlefield->advance(5) ;
+    for(int i = 0 ; i < 40 ; i += 7)
+        if(Robot* robot = findRobot(*battlefield, "R" + std::to_string(i)))
+            robot->kill() ;
+
+    const SpatialIndex& index = battlefield->getSpatialIndex() ;
+    const std::vector<Robot*>& robots = battlefield->getRobots() ;
+    bool same = true ;
+    std::vector<Robot*> found ;
+    for(int query = 0 ; query < 200 ; query++) {
+        int x = rand() % 60, y = rand() % 60, range = rand() % 12, team = rand() % 3 ;
+        Robot* exclude = robots[rand() % robots.size()] ;
+        Robot* best = nullptr ;
+        int bestDistance = INT32_MAX, count = 0 ;
+        std::vector<Robot*> inRange ;
+        for(Robot* robot : robots) {
+            if(robot == exclude || !robot->isAlive())
+                continue ;
+            int distance = std::max(std::abs(robot->getX() - x), std::abs(robot->getY() - y)) ;
+            if(distance <= range)
+                inRange.push_back(robot) ;
+            if(team != 0 && robot->getTeam() == team)
+                continue ;
+            count += distance <= range ;
+            if(distance < bestDistance || (distance == bestDistance && robot->getNameId() < best->getNameId())) {
+                best = robot ;
+                bestDistance = distance ;
+            }
+        }
+        found.clear() ;
+        index.withinRange(x, y, range, exclude, found) ;
+        std::sort(found.begin(), found.end()) ;
+        std::sort(inRange.begin(), inRange.end()) ;
+        same = same && index.nearest(x, y, exclude, team) == best && index.countWithin(x, y, range, exclude, team) == count && found == inRange ;
+    }
+    return same ;
+}
+
+static std::vector<int> scanDistances(const std::vector<bool>& blocked, int cols, int rows, const std::vector<int>& starts) {
+    std::vector<int> distances(cols * rows, FlowField::UNREACHED) ;      //plain 8-neighbour BFS, one cell at a time
+    std::deque<int> queue ;
+    for(int cell : starts) {
+        distances[cell] = 0 ;
+        queue.push_back(cell) ;
+    }
+    while(!queue.empty()) {
+        int cell = queue.front() ;
+        queue.pop_front() ;
+        for(int dy = -1 ; dy <= 1 ; dy++) {
+            for(int dx = -1 ; dx <= 1 ; dx++) {
+                int x = cell % cols + dx, y = cell / cols + dy ;
+                if(x < 0 || y < 0 || x >= cols || y >= rows || blocked[y * cols + x] || distances[y * cols + x] != FlowField::UNREACHED)
+                    continue ;
+                distances[y * cols + x] = distances[cell] + 1 ;
+                queue.push_back(y * cols + x) ;
+            }
+        }
+    }
+    return distances ;
+}
+
+static bool checkFlowFieldMatchesBfs() {           //both nearest sources per cell, so excluding either still gives the other's distance
+    const int cols = 10, rows = 10 ;
+    FlowField field ;
+    field.reset(cols, rows) ;
+    std::vector<bool> blocked(cols * rows, false) ;
+    for(int y = 0 ; y < rows - 1 ; y++) {              //a wall down the middle with a gap at the bottom
+        field.setBlocked(5, y, true) ;
+        blocked[y * cols + 5] = true ;
+    }
+    field.addSource(0, 0, 1) ;
+    field.addSource(9, 0, 2) ;
+    field.build() ;
+    std::vector<int> toFirst = scanDistances(blocked, cols, rows, {0}), toSecond = scanDistances(blocked, cols, rows, {9}) ;
+    bool same = true ;
+    for(int cell = 0 ; cell < cols * rows ; cell++) {
+        int x = cell % cols, y = cell / cols ;
+        if(blocked[cell])
+            continue ;
+        same = same && field.distance(x, y, 2) == toFirst[cell] && field.distance(x, y, 1) == toSecond[cell] &&
+               field.distance(x, y, 0) == std::min(toFirst[cell], toSecond[cell]) ;
+    }
+    return same && field.distance(4, 0, 1) == 18 ;
+}
+
+static bool checkFlowStepsReachObjective() {        //each flowStep goes one cell downhill, so the walk takes the Chebyshev distance
+    auto battlefield = quietBattlefield(header(12, 1) + "GenericRobot Walker 1 1\n") ;
+    Robot* walker = findRobot(*battlefield, "Walker") ;
+    battlefield->addObjective(8, 5) ;
+    battlefield->refreshFlowField() ;
+    int steps = 0, dx = 0, dy = 0 ;
+    while(steps < 20 && battlefield->flowStep(walker, dx, dy)) {
+        walker->setPosition(walker->getX() + dx, walker->getY() + dy) ;
+        steps++ ;
+    }
+    return steps == 7 && walker->getX() == 8 && walker->getY() == 5 && !battlefield->addObjective(12, 0) ;
+}
+
+static bool checkSharedCellTargetByRoster() {       //two robots on one cell : a shot hits the one earlier in the roster
+    auto battlefield = quietBattlefield(header(20, 2) + "GenericRobot First 1 1\nGenericRobot Second 2 2\n") ;
+    Robot* first = findRobot(*battlefield, "First") ;
+    first->setPosition(12, 12) ;                    //leaves the bucket and comes back behind Second
+    first->setPosition(2, 2) ;
+    return battlefield->robotAt(2, 2) == first ;
+}
+
+static bool checkTeamVisionMatchesScan() {         //bitset vision, cell counts and enemy cells agree with asking every robot
+    std::string scenario = header(30, 40) ;
+    for(int i = 0 ; i < 40 ; i++)
+        scenario += "GenericRobot V" + std::to_string(i) + " random random" + (i % 4 ? " team=" + std::to_string(i % 4) : "") + "\n" ;
+    srand(31) ;
+    auto battlefield = quietBattlefield(scenario) ;
+    const std::vector<Robot*>& robots = battlefield->getRobots() ;
+    for(size_t i = 0 ; i < robots.size() ; i += 9)
+        robots[i]->kill() ;
+
+    Visibility visibility ;
+    visibility.reset(30, 30) ;
+    visibility.build(robots) ;
+    std::pmr::vector<int> cells ;
+    bool same = true ;
+    for(int team = 1 ; team <= 3 ; team++) {
+        int seen = 0 ;
+        std::vector<int> enemies ;
+        for(int cell = 0 ; cell < 30 * 30 ; cell++) {
+            int x = cell % 30, y = cell / 30 ;
+            bool sees = false, occupied = false, mate = false ;
+            for(Robot* robot : robots) {
+                if(!robot->isAlive())
+                    continue ;
+                sees = sees || (robot->getTeam() == team && Visibility::robotSees(robot, x, y)) ;
+                if(robot->getX() == x && robot->getY() == y) {
+                    occupied = true ;
+                    mate = mate || robot->getTeam() == team ;
+                }
+            }
+            same = same && visibility.teamSees(team, x, y) == sees ;
+            seen += sees ;
+            if(sees && occupied && !mate)
+                enemies.push_back(cell) ;
+        }
+        int count = visibility.visibleEnemies(team, cells, 3) ;
+        same = same && visibility.visibleCells(team) == seen && count == int(enemies.size()) ;
+        enemies.resize(std::min<size_t>(enemies.size(), 3)) ;
+        same = same && std::vector<int>(cells.begin(), cells.end()) == enemies ;
+    }
+    return same && !visibility.teamSees(0, 0, 0) && !visibility.teamSees(1, 30, 0) ;
+}
+
+static bool checkTeamMatesNotHit() {               //a shot at a team mate's cell spends the shell and hurts nobody
+    auto battlefield = quietBattlefield(header(20, 3) +
+        "GenericRobot Shooter 2 2 team=1\nGenericRobot Mate 3 2 team=1\nGenericRobot Enemy 2 3 team=2\n") ;
+    auto* shooter = dynamic_cast<ShootingRobot*>(findRobot(*battlefield, "Shooter")) ;
+    Robot* mate = findRobot(*battlefield, "Mate") ;
+    Robot* enemy = findRobot(*battlefield, "Enemy") ;
+    int mateLives = mate->getLives(), enemyLives = enemy->getLives() ;
+    shooter->fire(1, 0) ;
+    shooter->fire(0, 1) ;
+    return mate->getLives() == mateLives && enemy->getLives() < enemyLives ;
+}
+
+static bool checkWalledRobotMoved() {              //a robot listed above the terrain that puts a wall on it is moved off
+    auto battlefield = quietBattlefield(header(4, 1) + "GenericRobot Walled 1 1\nterrain:\n....\n.#..\n....\n....\n") ;
+    Robot* walled = findRobot(*battlefield, "Walled") ;
+    return walled && !battlefield->getTerrain().isWall(walled->getX(), walled->getY()) && battlefield->isInside(walled->getX(), walled->getY()) ;
+}
+
+static bool checkTerrainRules() {                  //the map is read cell for cell, then walls, cover and slow ground do their part
+    const char* rows[] = {"......", ".#....", "..%...", "...~..", "......", "......"} ;
+    std::string scenario = header(6, 2) + "GenericRobot Wader 3 3\nGenericRobot Other 5 5\nterrain:\n" ;
+    for(const char* row : rows)
+        scenario += std::string(row) + "\n" ;
+    auto battlefield = quietBattlefield(scenario) ;
+    const Terrain& terrain = battlefield->getTerrain() ;
+    bool read = true ;
+    for(int y = 0 ; y < 6 ; y++)
+        for(int x = 0 ; x < 6 ; x++)
+            read = read && terrain.at(x, y) == Terrain::fromChar(rows[y][x]) ;
+
+    bool walls = !battlefield->canEnter(1, 1) && battlefield->canEnter(2, 2) && battlefield->canEnter(3, 2) &&
+                 battlefield->shotBlocked(0, 1, 2, 1) && battlefield->shotBlocked(0, 0, 2, 2) && battlefield->shotBlocked(0, 0, 1, 1) ;
+    bool cover = !battlefield->shotBlocked(1, 2, 2, 2) && battlefield->shotBlocked(0, 2, 2, 2) && battlefield->shotBlocked(2, 3, 2, 1) &&
+                 !battlefield->shotBlocked(3, 4, 3, 2) ;
+
+    auto* wader = dynamic_cast<MovingRobot*>(findRobot(*battlefield, "Wader")) ;
+    wader->move(1, 0) ;                                 //leaving slow ground takes a turn of wading first
+    bool waded = wader->getX() == 3 ;
+    wader->move(1, 0) ;
+    return read && walls && cover && waded && wader->getX() == 4 && wader->getY() == 3 ;
+}
+
+static std::string withoutTiming(const std::string& replies, const std::string& id) {    //one job's lines, id and ms= cut out
+    std::istringstream in(replies) ;
+    std::string line, kept ;
+    while(std::getline(in, line)) {
+        size_t space = line.find(' ') ;
+        if(space == std::string::npos || (line.compare(space + 1, id.size() + 1, id + " ") != 0 && line.substr(space + 1) != id))
+            continue ;
+        line = line.substr(0, space) + line.substr(space + 1 + id.size()) ;
+        size_t ms = line.find(" ms=") ;
+        kept += line.substr(0, ms) + "\n" ;
+    }
+    return kept ;
+}
+
+static bool checkMatchServiceProtocol() {          //--serve : jobs answered in full, bad ones get ERROR, QUIT ends the service
+    std::string path = tempPath("serve.sock") ;
+    std::ostringstream banner ;
+    std::streambuf* console = std::cout.rdbuf(banner.rdbuf()) ;       //keeps "Serving matches on ..." out of the check list
+    MatchService service(path) ;
+    std::thread server([&service]() { service.run(2) ; }) ;
+
+    sockaddr_un address {} ;
+    address.sun_family = AF_UNIX ;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1) ;
+    int fd = -1 ;
+    for(int attempt = 0 ; attempt < 200 && fd < 0 ; attempt++) {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0) ;
+        if(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            close(fd) ;
+            fd = -1 ;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10)) ;
+        }
+    }
+    std::string replies ;
+    if(fd >= 0) {
+        std::string scenario = header(8, 3, 30) + "GenericRobot Alpha 1 1\nGenericRobot Beta 5 5\nGenericRobot Gamma 2 6\n" ;
+        std::string requests = "JOB 1 9\n" + scenario + "END\nJOB 2 9\n" + scenario + "END\nJOB x\n" + scenario + "END\n" +
+                               "JOB 3\n" + header(8, 0) + "END\nBOGUS\nQUIT\n" ;
+        ::send(fd, requests.data(), requests.size(), MSG_NOSIGNAL) ;
+        char buffer[4096] ;
+        for(ssize_t got ; (got = recv(fd, buffer, sizeof(buffer), 0)) > 0 ; )      //the service closes it once every job answered
+            replies.append(buffer, got) ;
+        close(fd) ;
+    }
+    server.join() ;                                     //no connection means run() could not listen and returned already
+    std::cout.rdbuf(console) ;
+
+    std::string first = withoutTiming(replies, "1") ;
+    return first.rfind("RESULT winner=", 0) == 0 && first.find("\nTYPE GenericRobot alive=") != std::string::npos &&
+           first.size() > 6 && first.compare(first.size() - 4, 4, "END\n") == 0 && first == withoutTiming(replies, "2") &&
+           replies.find(" malformed JOB header\n") != std::string::npos && replies.find("ERROR 3 ") != std::string::npos &&
+           replies.find("ERROR - unknown command BOGUS\n") != std::string::npos && access(path.c_str(), F_OK) != 0 ;
+}
+
+static bool checkEventFeedOrderAndLoss() {         //oldest first, and a reader lapped by the ring counts what it missed
+    EventFeed feed(8) ;
+    EventFeed::Cursor cursor = feed.subscribe() ;
+    GameEvent events[16] ;
+    for(int i = 0 ; i < 5 ; i++)
+        feed.publish(EVENT_MOVE, i, 40 + i, i, -i, RobotKind::GenericRobot) ;
+    size_t got = feed.poll(cursor, events, 16) ;
+    bool ordered = got == 5 && cursor.lost == 0 ;
+    for(size_t i = 0 ; ordered && i < got ; i++)
+        ordered = events[i].sequence == i && events[i].step == i && events[i].nameId == 40 + i && events[i].x == int(i) && events[i].y == -int(i) ;
+
+    for(int i = 0 ; i < 20 ; i++)
+        feed.publish(EVENT_SHOT, 100 + i, 7, 0, 0, RobotKind::GenericRobot) ;
+    got = feed.poll(cursor, events, 16) ;
+    bool lapped = got == 8 && cursor.lost == 12 && cursor.next == feed.published() && events[0].step == 112 && events[7].step == 119 ;
+    return ordered && lapped && feed.poll(cursor, events, 16) == 0 ;
+}
+
+static bool checkEventFeedConcurrentReader() {     //a reader racing the producer never sees a torn or repeated event
+    EventFeed feed(64) ;
+    EventFeed::Cursor cursor = feed.subscribe() ;
+    const uint32_t total = 200000 ;
+    std::thread producer([&feed]() {
+        for(uint32_t i = 0 ; i < total ; i++)
+            feed.publish(GameEventType(i % EVENT_COUNT), i, i * 3, i % 1000, i % 777, RobotKind::GenericRobot) ;
+    }) ;
+    GameEvent events[32] ;
+    uint64_t received = 0, last = 0 ;
+    bool consistent = true, first = true ;
+    while(cursor.next < total) {
+        size_t got = feed.poll(cursor, events, 32) ;
+        for(size_t i = 0 ; i < got ; i++) {
+            const GameEvent& event = events[i] ;
+            consistent = consistent && event.step == event.sequence && event.nameId == event.step * 3 && event.x == int(event.step % 1000) &&
+                         event.y == int(event.step % 777) && event.type == GameEventType(event.step % EVENT_COUNT) && (first || event.sequence > last) ;
+            last = event.sequence ;
+            first = false ;
+        }
+        received += got ;
+    }
+    producer.join() ;
+    return consistent && received + cursor.lost == total ;
+}
+
+static bool checkSharedExportViewed() {            //--shm : a reader sees the latest step's board, and the segment outlives the writer only when kept
+    std::string scenario = header(8, 3, 10) + "GenericRobot Alpha 1 1\nGenericRobot Beta 5 5\nGenericRobot Gamma 2 6\n" ;
+    std::string name = "/full_tests_" + std::to_string(getpid()) + "_shm" ;
+    bool seen = false, kept = false ;
+    for(bool keep : {false, true}) {
+        std::string expected ;
+        {
+            auto battlefield = quietBattlefield(scenario) ;
+            if(!battlefield->startSharedExport(name, keep))
+                return false ;
+            srand(41) ;
+            int ran = battlefield->advance(3) ;
+            BoardFormatter board ;
+            board.begin(battlefield->getRows(), battlefield->getCols()) ;
+            for(Robot* robot : battlefield->getRobots())
+                if(robot->isAlive())
+                    board.place(robot->getX(), robot->getY(), robot->getName()) ;
+            board.write(expected) ;
+            std::ostringstream live ;
+            bool viewed = SharedStateExport::view(name, live) && live.str() == "Step: " + std::to_string(ran) + "\n" + expected ;
+            seen = keep ? seen && viewed : viewed ;
+        }
+        std::ostringstream after ;
+        bool left = SharedStateExport::view(name, after) ;
+        kept = keep ? kept && left && after.str().find(" (writer gone)\n") != std::string::npos : !left ;
+    }
+    shm_unlink(name.c_str()) ;
+    return seen && kept ;
+}
+
+static bool checkForkIndependent() {               //a fork starts equal, owns its robots and leaves the original alone as it plays
+    auto battlefield = quietBattlefield(header(8, 5, 60) + "GenericRobot Alpha 1 1\nGenericRobot Beta 3 2\nGenericRobot Gamma 6 6\nGenericRobot Delta 2 5\nGenericRobot Echo 5 3\n") ;
+    srand(42) ;
+    battlefield->advance(20) ;
+    uint64_t hash = battlefield->getStateHash() ;
+    auto robotLines = [](Battlefield& of) {           //a fork may hand out roster slots in another order
+        std::istringstream in(replayLines(of)) ;
+        std::vector<std::string> lines ;
+        for(std::string line ; std::getline(in, line) ; )
+            lines.push_back(line) ;
+        std::sort(lines.begin(), lines.end()) ;
+        return lines ;
+    } ;
+    std::vector<std::string> before = robotLines(*battlefield) ;
+
+    std::unique_ptr<Battlefield> copy = battlefield->fork(5) ;
+    bool equal = copy->getStateHash() == hash && copy->computeStateHash() == hash && robotLines(*copy) == before &&
+                 copy->getRobots().size() == battlefield->getRobots().size() ;
+    for(Robot* robot : copy->getRobots()) {
+        Robot* original = findRobot(*battlefield, robot->getName()) ;
+        equal = equal && original && original != robot && robot->getBattlefield() == copy.get() && robot->getKind() == original->getKind() ;
+    }
+    copy->advance(30) ;
+    return equal && copy->computeStateHash() == copy->getStateHash() && battlefield->getStateHash() == hash && robotLines(*battlefield) == before ;
+}
+
+static bool checkForkIntoMatchesFork() {           //a reused scratch battlefield plays a seed exactly like a fresh fork
+    auto battlefield = quietBattlefield(header(8, 5, 60) + "GenericRobot Alpha 1 1\nGenericRobot Beta 3 2\nGenericRobot Gamma 6 6\nGenericRobot Delta 2 5\nGenericRobot Echo 5 3\n") ;
+    srand(43) ;
+    battlefield->advance(10) ;
+    auto scratch = quietBattlefield() ;
+    battlefield->forkInto(*scratch, 6) ;                //dirty the scratch with another line of play first
+    scratch->advance(25) ;
+    battlefield->forkInto(*scratch, 7) ;
+    scratch->advance(25) ;
+    std::unique_ptr<Battlefield> fresh = battlefield->fork(7), again = battlefield->fork(7) ;
+    fresh->advance(25) ;
+    again->advance(25) ;
+    return scratch->getStateHash() == fresh->getStateHash() && fresh->getStateHash() == again->getStateHash() &&
+           replayLines(*scratch) == replayLines(*fresh) ;
+}
+
+/*the global allocator replaced for the whole test program, counting only while a check arms it. the aligned forms
+are replaced too, so over-aligned objects cannot slip past the count*/
+static std::atomic<bool> countAllocations {false} ;
+static std::atomic<uint64_t> allocations {0} ;
+
+static void* countedAllocate(size_t bytes, size_t alignment) {
+    if(countAllocations.load(std::memory_order_relaxed))
+        allocations.fetch_add(1, std::memory_order_relaxed) ;
+    bytes = std::max<size_t>(bytes, 1) ;
+    void* block = alignment <= alignof(std::max_align_t) ? std::malloc(bytes) : std::aligned_alloc(alignment, (bytes + alignment - 1) / alignment * alignment) ;
+    if(!block)
+        throw std::bad_alloc() ;
+    return block ;
+}
+
+void* operator new(size_t bytes) { return countedAllocate(bytes, 0) ; }
+void* operator new[](size_t bytes) { return countedAllocate(bytes, 0) ; }
+void* operator new(size_t bytes, std::align_val_t alignment) { return countedAllocate(bytes, size_t(alignment)) ; }
+void* operator new[](size_t bytes, std::align_val_t alignment) { return countedAllocate(bytes, size_t(alignment)) ; }
+void operator delete(void* block) noexcept { std::free(block) ; }
+void operator delete[](void* block) noexcept { std::free(block) ; }
+void operator delete(void* block, size_t) noexcept { std::free(block) ; }
+void operator delete[](void* block, size_t) noexcept { std::free(block) ; }
+void operator delete(void* block, std::align_val_t) noexcept { std::free(block) ; }
+void operator delete[](void* block, std::align_val_t) noexcept { std::free(block) ; }
+void operator delete(void* block, size_t, std::align_val_t) noexcept { std::free(block) ; }
+void operator delete[](void* block, size_t, std::align_val_t) noexcept { std::free(block) ; }
+
+static bool checkWarmStepsDoNotAllocate() {        //a battlefield replaying the same match, as a service worker does, never calls new
+    std::string scenario = header(10, 6, 60) + "GenericRobot Alpha 1 1 team=1\nGenericRobot Beta 3 2 team=1\nGenericRobot Gamma 6 6\n"
+                           "GenericRobot Delta 2 5\nGenericRobot Echo 5 3 team=2\nGenericRobot Foxtrot 8 8 team=2\n" ;
+    auto battlefield = quietBattlefield() ;
+    uint64_t counted[3] = {} ;
+    int ran[3] = {} ;
+    for(int round = 0 ; round < 3 ; round++) {      //the first round grows every container to its size for this match
+        battlefield->clear() ;
+        battlefield->seedRandom(12) ;
+        if(!battlefield->loadFromText(scenario))
+            return false ;
+        allocations = 0 ;
+        countAllocations = true ;
+        ran[round] = battlefield->advance(60) ;
+        countAllocations = false ;
+        counted[round] = allocations ;
+    }
+    return counted[0] > 0 && counted[1] == 0 && counted[2] == 0 && ran[1] == ran[0] && ran[2] == ran[0] && ran[0] > 10 ;
+}
+
+static bool checkBitboardCountsMatchScan() {       //row, column and block counts over word boundaries agree with a plain count array
+    const int cols = 70, rows = 50 ;
+    Bitboard board ;
+    board.reset(cols, rows) ;
+    std::vector<int> robots(cols * rows, 0) ;
+    srand(44) ;
+    for(int i = 0 ; i < 3000 ; i++) {
+        int x = rand() % cols, y = rand() % rows ;
+        if(robots[y * cols + x] > 0 && rand() % 3 == 0) {
+            board.remove(x, y) ;
+            robots[y * cols + x]-- ;
+        }
+        else {
+            board.add(x, y) ;
+            robots[y * cols + x]++ ;
+        }
+    }
+    auto occupied = [&](int x, int y) { return x >= 0 && y >= 0 && x < cols && y < rows && robots[y * cols + x] > 0 ; } ;
+    bool same = true ;
+    for(int y = 0 ; y < rows ; y++)
+        for(int x = 0 ; x < cols ; x++)
+            same = same && board.test(x, y) == occupied(x, y) && board.robotsOn(x, y) == robots[y * cols + x] ;
+    for(int query = 0 ; query < 500 ; query++) {
+        int x = rand() % (cols + 4) - 2, y = rand() % (rows + 4) - 2, from = rand() % (cols + 4) - 2, to = from + rand() % 80 ;
+        int row = 0, column = 0, around = 0 ;
+        for(int i = from ; i <= to ; i++) {
+            row += occupied(i, y) ;
+            column += occupied(x, i) ;
+        }
+        for(int dy = -1 ; dy <= 1 ; dy++)
+            for(int dx = -1 ; dx <= 1 ; dx++)
+                around += occupied(x + dx, y + dy) ;
+        same = same && board.countRow(y, from, to) == row && board.countColumn(x, from, to) == column && board.countAround(x, y) == around ;
+    }
+    return same && !board.test(-1, 0) && !board.test(cols, 0) ;
+}
+
+static bool checkBitboardFollowsMatch() {          //every live robot's cell stays marked, and the match plays as it does without the board
+    std::string scenario = header(12, 6, 40) + "GenericRobot Alpha 1 1\nGenericRobot Beta 3 2\nGenericRobot Gamma 6 6\n"
+                           "GenericRobot Delta 2 5\nGenericRobot Echo 5 3\nGenericRobot Foxtrot 9 9\n" ;
+    uint64_t hashes[2] ;
+    bool marked = true, used[2] ;
+    for(int i = 0 ; i < 2 ; i++) {
+        auto battlefield = quietBattlefield() ;
+        battlefield->setBitboardLimit(i == 0 ? BITBOARD_MAX_CELLS : 0) ;
+        battlefield->loadFromText(scenario) ;
+        used[i] = battlefield->usesBitboard() ;
+        srand(45) ;
+        for(int step = 0 ; step < 40 ; step++) {
+            battlefield->advance(1) ;
+            for(Robot* robot : battlefield->getRobots())
+                marked = marked && (!robot->isAlive() || battlefield->mayHaveRobot(robot->getX(), robot->getY())) ;
+        }
+        hashes[i] = battlefield->getStateHash() ;
+    }
+    return used[0] && !used[1] && marked && hashes[0] == hashes[1] ;
+}
+
+static bool checkStateHashConsistent() {            //incremental hash matches a full recompute, and alike robots do not cancel
+    auto battlefield = quietBattlefield(header(12, 4, 40) +
+        "GenericRobot Twin 1 1\nGenericRobot Twin 2 2\nGenericRobot Kidd 5 5\nGenericRobot Bolt 8 8\n") ;
+    Robot* twins[2] = {} ;
+    for(Robot* robot : battlefield->getRobots())
+        if(robot->getName() == "Twin")
+            twins[twins[0] ? 1 : 0] = robot ;
+    twins[1]->setPosition(1, 1) ;                   //both twins now have every field alike
+    uint64_t pair = twins[0]->stateHash() ^ twins[1]->stateHash() ;
+    if(pair == 0 || battlefield->computeStateHash() != battlefield->getStateHash())
+        return false ;
+    srand(3) ;
+    for(int step = 0 ; step < 40 ; step++) {
+        battlefield->advance(1) ;
+        if(battlefield->computeStateHash() != battlefield->getStateHash())
+            return false ;
+    }
+    return true ;
+}
+
+static bool checkStateHashFollowsFields() {        //any field change moves the hash, undoing it brings the same hash back
+    auto battlefield = quietBattlefield(header(12, 2) + "GenericRobot Alpha 1 1\nGenericRobot Beta 7 7\n") ;
+    Robot* alpha = findRobot(*battlefield, "Alpha") ;
+    int lives = alpha->getLives() ;
+    uint64_t start = battlefield->getStateHash() ;
+    std::unordered_set<uint64_t> seen = {start} ;
+    alpha->setPosition(2, 1) ;
+    seen.insert(battlefield->getStateHash()) ;
+    alpha->setLives(lives + 1) ;
+    seen.insert(battlefield->getStateHash()) ;
+    alpha->setUpgradeFirst(true) ;
+    seen.insert(battlefield->getStateHash()) ;
+    bool changed = seen.size() == 4 && battlefield->computeStateHash() == battlefield->getStateHash() ;
+    alpha->setUpgradeFirst(false) ;
+    alpha->setLives(lives) ;
+    alpha->setPosition(1, 1) ;
+    return changed && battlefield->getStateHash() == start ;
+}
+
+static bool checkHashTraceLines() {                 //--hash-trace : one "step hash" line per step, a repeated state names an earlier step
+    auto battlefield = quietBattlefield(header(12, 2, 30) + "GenericRobot Alpha 1 1\nGenericRobot Beta 9 9\n") ;
+    std::string path = tempPath("hashes.txt") ;
+    if(!battlefield->startHashTrace(path))
+        return false ;
+    srand(46) ;
+    int ran = battlefield->advance(30) ;
+    battlefield.reset() ;                               //closes the trace
+    std::istringstream in(readFile(path)) ;
+    std::remove(path.c_str()) ;
+    std::map<unsigned long long, int> first ;
+    int lines = 0 ;
+    bool formatted = true ;
+    for(std::string line ; std::getline(in, line) ; ) {
+        unsigned long long hash = 0 ;
+        int step = -1, length = 0, repeated = -1 ;
+        formatted = formatted && sscanf(line.c_str(), "%d %16llx%n", &step, &hash, &length) == 2 && step == ++lines ;
+        if(length < int(line.size()))
+            formatted = formatted && sscanf(line.c_str() + length, " repeat %d", &repeated) == 1 && first.count(hash) && first[hash] == repeated ;
+        else
+            formatted = formatted && !first.count(hash) ;
+        first.emplace(hash, step) ;
+    }
+    return formatted && ran > 0 && lines == ran ;
+}
+
+static std::string printedMatch(const std::string& scenario, int depth) {     //everything a full run prints, console only
+    std::ostringstream printed ;
+    std::streambuf* console = std::cout.rdbuf(printed.rdbuf()) ;
+    {
+        Battlefield battlefield(MAX_ROWS, MAX_COLS, new Logger("")) ;
+        battlefield.setPipelineDepth(depth) ;
+        srand(47) ;
+        if(battlefield.loadFromText(scenario))
+            battlefield.runSimulation() ;
+    }
+    std::cout.rdbuf(console) ;
+    return printed.str() ;
+}
+
+static bool checkPipelinedOutputMatchesInline() {  //--pipeline=N : the render thread writes the same bytes in the same order
+    std::string scenario = header(10, 5, 40) + "GenericRobot Alpha 1 1\nGenericRobot Beta 3 2\nGenericRobot Gamma 6 6\n"
+                           "GenericRobot Delta 2 5\nGenericRobot Echo 5 3\nterrain:\n..........\n..#.......\n....%.....\n..........\n"
+                           ".......~..\n..........\n..........\n...#......\n..........\n..........\n" ;
+    std::string inline_ = printedMatch(scenario, 0) ;
+    return inline_.find("Step: 40") != std::string::npos && printedMatch(scenario, 1) == inline_ && printedMatch(scenario, 4) == inline_ ;
+}
+
+static std::vector<std::string> firstTurnOrder(const std::string& scenario, int sortInterval) {    //names as their turns start in step 1
+    Battlefield battlefield(MAX_ROWS, MAX_COLS, new Logger("")) ;
+    battlefield.setRosterSortInterval(sortInterval) ;
+    std::string log ;
+    battlefield.getLogger()->capture(&log) ;
+    srand(3) ;
+    std::vector<std::string> order ;
+    if(!battlefield.loadFromText(scenario))
+        return order ;
+    log.clear() ;
+    battlefield.advance(1) ;
+    battlefield.getLogger()->capture(nullptr) ;
+    for(size_t end = log.find(" is thinking") ; end != std::string::npos ; end = log.find(" is thinking", end + 1)) {
+        size_t start = log.rfind('\n', end) ;
+        order.push_back(log.substr(start == std::string::npos ? 0 : start + 1, end - (start == std::string::npos ? 0 : start + 1))) ;
+    }
+    return order ;
+}
+
+static bool checkMortonSortOrdersTurns() {         //--morton-sort : turns follow the Z-order of the board, not the load order
+    struct Placed { const char* name ; int x, y ; } ;
+    std::vector<Placed> placed = {{"Fox", 17, 16}, {"Elk", 9, 2}, {"Owl", 2, 14}, {"Ant", 1, 1}, {"Yak", 12, 12}} ;
+    std::string scenario = header(20, placed.size(), 3) ;
+    for(const Placed& robot : placed)
+        scenario += "GenericRobot " + std::string(robot.name) + " " + std::to_string(robot.x) + " " + std::to_string(robot.y) + "\n" ;
+
+    std::vector<std::string> loadOrder, mortonOrder ;
+    for(const Placed& robot : placed)
+        loadOrder.push_back(robot.name) ;
+    std::stable_sort(placed.begin(), placed.end(), [](const Placed& a, const Placed& b) { return mortonIndex(a.x, a.y) < mortonIndex(b.x, b.y) ; }) ;
+    for(const Placed& robot : placed)
+        mortonOrder.push_back(robot.name) ;
+
+    auto sortedRun = [&scenario]() {
+        auto battlefield = quietBattlefield() ;
+        battlefield->setRosterSortInterval(1) ;
+        srand(3) ;
+        battlefield->loadFromText(scenario) ;
+        battlefield->advance(3) ;
+        return replayLines(*battlefield) ;
+    } ;
+    return mortonOrder != loadOrder && firstTurnOrder(scenario, 0) == loadOrder && firstTurnOrder(scenario, 1) == mortonOrder &&
+           sortedRun() == sortedRun() ;
+}
+
+static bool checkRobotSlotsGenerations() {         //stale handles read nullptr, reused slots move on, compact keeps the order
+    auto battlefield = quietBattlefield() ;
+    std::vector<std::unique_ptr<GenericRobot>> owned ;
+    for(const char* name : {"Ann", "Bob", "Cat", "Dan"})
+        owned.emplace_back(new GenericRobot("GenericRobot", name, 0, 0, battlefield.get())) ;
+    RobotSlots slots ;
+    for(auto& robot : owned)
+        robot->setHandle(slots.insert(robot.get())) ;
+
+    RobotHandle stale = owned[1]->getHandle() ;
+    slots.remove(stale) ;
+    slots.remove(stale) ;                               //a second remove of the same handle does nothing
+    bool staleNull = slots.get(stale) == nullptr && slots.size() == 4 && slots[1] == nullptr && slots.get(owned[2]->getHandle()) == owned[2].get() ;
+
+    std::unique_ptr<GenericRobot> late(new GenericRobot("GenericRobot", "Eve", 0, 0, battlefield.get())) ;
+    late->setHandle(slots.insert(late.get())) ;
+    bool reused = late->getHandle().index == stale.index && late->getHandle().generation != stale.generation &&
+                  slots.get(stale) == nullptr && slots.get(late->getHandle()) == late.get() ;
+
+    slots.compact() ;
+    std::vector<Robot*> expected = {owned[0].get(), owned[2].get(), owned[3].get(), late.get()} ;
+    bool positions = slots.all() == expected ;
+    for(size_t i = 0 ; i < expected.size() ; i++)
+        positions = positions && slots.position(expected[i]->getHandle()) == i && slots.get(expected[i]->getHandle()) == expected[i] ;
+    return staleNull && reused && positions ;
+}
+
+static bool checkTickClockPacesAndCounts() {       //--realtime=HZ : steps wait for their tick, late ones skip renders, far behind resyncs
+    using namespace std::chrono ;
+    TickClock clock ;
+    clock.start(100) ;                                  //10 ms ticks, half a tick late skips the render, 40 ms behind resyncs
+    bool onTime = clock.waitTick() ;
+    std::this_thread::sleep_for(milliseconds(20)) ;     //overrun, not yet far enough behind to resync
+    clock.endStep() ;
+    bool lateSkipped = !clock.waitTick() ;
+    std::this_thread::sleep_for(milliseconds(60)) ;
+    clock.endStep() ;
+    bool laggingSkipped = !clock.waitTick() ;
+    clock.endStep() ;
+    std::string report ;
+    clock.report(report) ;
+    bool counted = onTime && lateSkipped && laggingSkipped && report.find("Real-time 100 steps/s: 3 steps") == 0 &&
+                   report.find("2 overruns, 2 renders skipped, 1 resyncs") != std::string::npos ;
+
+    Battlefield battlefield(MAX_ROWS, MAX_COLS, new Logger("")) ;
+    std::string log ;
+    battlefield.getLogger()->capture(&log) ;
+    battlefield.setTickRate(50) ;
+    srand(9) ;
+    bool loaded = battlefield.loadFromText(header(20, 2, 5) + "GenericRobot Alpha 1 1\nGenericRobot Beta 18 18\n") ;
+    steady_clock::time_point started = steady_clock::now() ;
+    battlefield.runSimulation() ;
+    steady_clock::duration took = steady_clock::now() - started ;
+    battlefield.getLogger()->capture(nullptr) ;
+    return counted && loaded && took >= milliseconds(4 * 20) && log.find("Real-time 50 steps/s: 5 steps") != std::string::npos ;
+}
+
+static bool checkScriptActsOncePerTurn() {         //a script looping over move and fire still moves one cell and fires once
+    auto battlefield = quietBattlefield(header(20, 2) +
+        "script: runner\n  set r0 1\nloop:\n  look r0 r0\n  move r0 r0\n  fire r0 r0\n  jmp loop\nend\n"
+        "GenericRobot Runner 2 2 script=runner\nGenericRobot Target 15 15\n") ;
+    srand(1) ;
+    battlefield->advance(1) ;
+    auto* runner = dynamic_cast<ShootingRobot*>(findRobot(*battlefield, "Runner")) ;
+    return runner && runner->getX() == 3 && runner->getY() == 3 && runner->getShells() == 9 && runner->isAlive() ;
+}
+
+static bool checkScriptAssemblyAndArithmetic() {   //errors name their line, arithmetic (divide by zero too) steers the move
+    const char* broken[][2] = {
+        {"set r0 1\n# fine\n  jump r0\n", "line 3: "},
+        {"set r0 1\njz r0 nowhere\n", "line 2: "},
+        {"set r16 1\n", "line 1: "},
+        {"mov r0\n", "line 1: "},
+    } ;
+    bool reported = true ;
+    for(auto& source : broken) {
+        ScriptProgram program("broken") ;
+        std::string error ;
+        reported = reported && !program.assemble(source[0], error) && error.rfind(source[1], 0) == 0 ;
+    }
+
+    auto battlefield = quietBattlefield(header(20, 2) +
+        "script: sums\n  set r0 7\n  set r1 3\n  div r2 r0 r1  ; 2\n  mod r3 r0 r1  ; 1\n  sub r4 r2 r3  ; 1\n"
+        "  set r5 0\n  div r6 r0 r5  ; 0\n  move r4 r6\nend\n"
+        "GenericRobot Summer 2 2 script=sums\nGenericRobot Target 15 15\n") ;
+    srand(1) ;
+    battlefield->advance(1) ;
+    Robot* summer = findRobot(*battlefield, "Summer") ;
+    return reported && summer && summer->getX() == 3 && summer->getY() == 2 ;
+}
+
+static bool checkUnterminatedScriptRejected() {     //a script block with no "end" fails the load instead of eating the robots
+    return !quietBattlefield()->loadFromText(header(20, 1) + "script: runner\n  move 1 1\nGenericRobot Runner 2 2\n") ;
+}
+
+int main() {
+    struct Check { const char* name ; bool (*run)() ; } ;
+    static const Check checks[] = {
+        {"streamed lines match the text", checkStreamedLinesMatchText},
+        {"bad counts and sizes rejected", checkBadCountsRejected},
+        {"binary scenario round trip", checkBinaryScenarioRoundTrip},
+        {"latency percentiles", checkLatencyPercentiles},
+        {"step metrics follow the run", checkStepMetricsFollowTheRun},
+        {"perf counters or fallback", checkPerfCountersOrFallback},
+        {"names interned once", checkNamesInternedOnce},
+        {"robot record packs state", checkRobotRecordPacksState},
+        {"typed dispatch matches roster", checkTypedDispatchMatchesRoster},
+        {"typed dispatch runs every kind", checkTypedDispatchRunsEveryKind},
+        {"policy robots match classes", checkPolicyRobotsMatchClasses},
+        {"policy match plays the same", checkPolicyMatchPlaysTheSame},
+        {"step draws repeatable", checkStepDrawsRepeatable},
+        {"bulk match repeatable", checkBulkMatchRepeatable},
+        {"bulk rolls ignore turn order", checkBulkRollsIgnoreTurnOrder},
+        {"replay seeks to every step", checkReplaySeeksToEveryStep},
+        {"spatial queries match a scan", checkSpatialQueriesMatchScan},
+        {"shared cell target by roster order", checkSharedCellTargetByRoster},
+        {"flow field matches a BFS", checkFlowFieldMatchesBfs},
+        {"flow steps reach the objective", checkFlowStepsReachObjective},
+        {"team vision matches a scan", checkTeamVisionMatchesScan},
+        {"team mates not hit", checkTeamMatesNotHit},
+        {"walled robot moved off the wall", checkWalledRobotMoved},
+        {"terrain rules", checkTerrainRules},
+        {"match service protocol", checkMatchServiceProtocol},
+        {"event feed order and loss", checkEventFeedOrderAndLoss},
+        {"event feed concurrent reader", checkEventFeedConcurrentReader},
+        {"shared export viewed", checkSharedExportViewed},
+        {"fork independent", checkForkIndependent},
+        {"forkInto matches fork", checkForkIntoMatchesFork},
+        {"warm steps do not allocate", checkWarmStepsDoNotAllocate},
+        {"bitboard counts match a scan", checkBitboardCountsMatchScan},
+        {"bitboard follows the match", checkBitboardFollowsMatch},
+        {"state hash consistent", checkStateHashConsistent},
+        {"state hash follows fields", checkStateHashFollowsFields},
+        {"hash trace lines", checkHashTraceLines},
+        {"pipelined output matches inline", checkPipelinedOutputMatchesInline},
+        {"morton sort orders turns", checkMortonSortOrdersTurns},
+        {"robot slot generations", checkRobotSlotsGenerations},
+        {"tick clock paces and counts", checkTickClockPacesAndCounts},
+        {"script actions once per turn", checkScriptActsOncePerTurn},
+        {"unterminated script rejected", checkUnterminatedScriptRejected},
+        {"script assembly and arithmetic", checkScriptAssemblyAndArithmetic},
+    } ;
+    int failed = 0 ;
+    for(const Check& check : checks) {
+        bool ok = check.run() ;
+        std::cout << (ok ? "ok   " : "FAIL ") << check.name << "\n" ;
+        failed += !ok ;
+    }
+    return failed ? 1 : 0 ;
+}
@@ -0,0 +1,99 @@
+#include "Visibility.h"
+#include "Battlefield.h"
+
+void Visibility::reset(int c, int r) {
+    cols = c ;
+    rows = r ;
+    words = (size_t(cols) * rows + 63) / 64 ;
+    alive.assign(words, 0) ;
+    for(auto& bits : teamVision)
+        bits.clear() ;                              //emptied, not freed, for the next match on this battlefield
+    for(auto& bits : teamAlive)
+        bits.clear() ;
+}
+
+void Visibility::setSpan(std::vector<uint64_t>& bits, size_t begin, size_t end) {
+    size_t first = begin >> 6, last = (end - 1) >> 6 ;
+    uint64_t head = ~0ull << (begin & 63) ;
+    uint64_t tail = ~0ull >> (63 - ((end - 1) & 63)) ;
+    if(first == last) {
+        bits[first] |= head & tail ;
+        return ;
+    }
+    bits[first] |= head ;
+    for(size_t word = first + 1 ; word < last ; word++)
+        bits[word] = ~0ull ;
+    bits[last] |= tail ;
+}
+
+void Visibility::build(const std::vector<Robot*>& robots) {
+    std::fill(alive.begin(), alive.end(), 0) ;
+    for(auto& bits : teamVision)
+        std::fill(bits.begin(), bits.end(), 0) ;
+    for(auto& bits : teamAlive)
+        std::fill(bits.begin(), bits.end(), 0) ;
+
+    for(Robot* robot : robots) {
+        int x = robot->getX(), y = robot->getY() ;
+        if(!robot->isAlive() || x < 0 || y < 0 || x >= cols || y >= rows)
+            continue ;
+
+        size_t cell = size_t(y) * cols + x ;
+        alive[cell >> 6] |= 1ull << (cell & 63) ;
+
+        int team = robot->getTeam() ;
+        if(team == 0)
+            continue ;
+        if(size_t(team) >= teamVision.size()) {
+            teamVision.resize(team + 1) ;
+            teamAlive.resize(team + 1) ;
+        }
+        if(teamVision[team].empty()) {
+            teamVision[team].assign(words, 0) ;
+            teamAlive[team].assign(words, 0) ;
+        }
+        teamAlive[team][cell >> 6] |= 1ull << (cell & 63) ;
+
+        int x0 = std::max(0, x - RANGE), x1 = std::min(cols - 1, x + RANGE) ;
+        for(int row = std::max(0, y - RANGE) ; row <= std::min(rows - 1, y + RANGE) ; row++)
+            setSpan(teamVision[team], size_t(row) * cols + x0, size_t(row) * cols + x1 + 1) ;
+    }
+}
+
+bool Visibility::robotSees(const Robot* robot, int x, int y) {
+    return std::abs(robot->getX() - x) <= RANGE && std::abs(robot->getY() - y) <= RANGE ;
+}
+
+bool Visibility::teamSees(int team, int x, int y) const {
+    if(team <= 0 || size_t(team) >= teamVision.size() || teamVision[team].empty() || x < 0 || y < 0 || x >= cols || y >= rows)
+        return false ;
+    return test(teamVision[team], size_t(y) * cols + x) ;
+}
+
+int Visibility::visibleCells(int team) const {
+    if(team <= 0 || size_t(team) >= teamVision.size())
+        return 0 ;
+    int count = 0 ;
+    for(uint64_t word : teamVision[team])
+        count += __builtin_popcountll(word) ;
+    return count ;
+}
+
+int Visibility::visibleEnemies(int team, std::pmr::vector<int>& cells, size_t limit) const {
+    cells.clear() ;
+    if(team <= 0 || size_t(team) >= teamVision.size() || teamVision[team].empty())
+        return 0 ;
+
+    const std::vector<uint64_t>& vision = teamVision[team] ;
+    const std::vector<uint64_t>& mates = teamAlive[team] ;
+    int count = 0 ;
+    for(size_t word = 0 ; word < words ; word++) {
+        uint64_t enemies = vision[word] & alive[word] & ~mates[word] ;
+        count += __builtin_popcountll(enemies) ;
+        while(enemies && cells.size() < limit) {
+            cells.push_back(int(word * 64 + __builtin_ctzll(enemies))) ;
+            enemies &= enemies - 1 ;
+        }
+    }
+    return count ;
+}
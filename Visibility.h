@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Common.h"
+
+/*team vision as packed bitsets over the board, one bit per cell in row major order. built once per step : every
+live team robot sees the square of RANGE cells around itself, OR-ed into its team's map a row span at a time,
+then queries are word-wide AND, popcount and bit scans against the live robot maps*/
+class Visibility {
+public:
+    static const int RANGE = 2 ;
+
+    void reset(int cols, int rows) ;
+    void build(const std::vector<Robot*>& robots) ;
+    static bool robotSees(const Robot* robot, int x, int y) ;
+    bool teamSees(int team, int x, int y) const ;
+    int visibleCells(int team) const ;
+    int visibleEnemies(int team, std::pmr::vector<int>& cells, size_t limit) const ;    //count, and the first limit cells
+
+private:
+    int cols = 0, rows = 0 ;
+    size_t words = 0 ;
+    std::vector<uint64_t> alive ;
+    std::vector<std::vector<uint64_t>> teamVision, teamAlive ;      //by team id, team 0 unused
+
+    static void setSpan(std::vector<uint64_t>& bits, size_t begin, size_t end) ;    //bits [begin, end)
+    static bool test(const std::vector<uint64_t>& bits, size_t bit) { return bits[bit >> 6] >> (bit & 63) & 1 ; }
+};
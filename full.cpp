@@ -1,879 +1,4 @@
-#include <iostream>
-#include <vector>
-#include <string>
-#include <cstdlib>
-#include <ctime>
-#include <fstream>
-#include <sstream>
-#include <algorithm>
-
-const int MAX_ROWS = 80;
-const int MAX_COLS = 50;
-
-/*Starting from here is all of the class definition
-xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
-xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
-xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
-xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
-xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
-*/
-
-class Robot;
-
-class Logger {
-    std::ofstream logFile;
-
-public:
-    Logger(const std::string& filename) ;
-    ~Logger() ;
-
-    void log(const std::string& message) ;
-};
-
-class Battlefield {
-    int rows, cols, steps;
-    std::vector<std::vector<std::string>> grid;
-    std::vector<Robot*> robots;                     //pointer
-    std::vector<Robot*> graveyard ;                 //queue
-    Logger* logger;
-
-public:
-    Battlefield(int r, int c) : rows(r), cols(c), grid(r, std::vector<std::string>(c, "+___")) {
-        logger = new Logger("log.txt") ;
-    }
-    ~Battlefield();
-
-    int getRows() ;
-    int getCols() ;
-    int getSteps() ;
-    std::vector<Robot*>& getRobots() ;
-    Logger* getLogger() ;
-
-    void setRows(int row) ;
-    void setCols(int col) ;
-    void setSteps(int step) ;
-
-    void loadFromFile(const std::string& filename);
-    void runSimulation();
-    void display();
-    bool isInside(int x, int y);
-    bool isOccupied(int x, int y);
-    void createRobot(Robot* robot);
-    void enterGraveyard(Robot* robot) ;
-    void reviveOne() ;
-    void upgrade(Robot* robot) ;
-    Robot* createUpgradedRobot(Robot* robot) ;
-    Battlefield& operator<<(Robot* robot) ; //operator overloading. basically this one will call createRobot() to insert
-};                                          //new robot into the vector. (bf << robot ;) it's like saying insert robot into battlefield
-
-class Robot {
-protected:
-    std::string type, name;
-    int posX, posY;
-    int lives = 1;
-    int revivals = 3 ;
-    bool upgradeFirst = false ;
-    bool upgradeSecond = false ;
-    bool upgradeThird = false ;
-    int upgradePoints = 0 ;
-    Battlefield* battlefield ;
-
-public:
-    Robot(const std::string& t,const std::string& n, int x, int y , Battlefield* bf) :
-        type(t), name(n), posX(x), posY(y) , battlefield(bf) {}
-
-    virtual void takeTurn() = 0;
-    virtual bool isAlive() const { return lives > 0; }
-    bool canRevive() { return revivals > 0 ; }
-
-    std::string getType() const { return type; }
-    std::string getName() const { return name; }
-    int getX() const { return posX; }
-    int getY() const { return posY; }
-    int getRevivals() const { return revivals ; }
-    bool getUpgradeFirst() { return upgradeFirst ; }
-    bool getUpgradeSecond() { return upgradeSecond ; }
-    bool getUpgradeThird() { return upgradeThird ; }
-    int getUpgradePoints() { return upgradePoints ; }
-
-    void setType(const std::string& type) { this->type = type ; }
-    void setName(const std::string& name) { this->name = name ; }
-    void setRevivals(int revival) { revivals = revival ; }
-    void setPosition(int x, int y) { posX = x; posY = y; }
-    void setLives(int live) { lives = live ; }
-    void setUpgradeFirst(const bool state) { upgradeFirst = state ; }
-    void setUpgradeSecond(bool state) { upgradeSecond = state ; }
-    void setUpgradeThird(bool state) { upgradeThird = state ; }
-    void setUpgradePoints(int upgradePoint) { upgradePoints = upgradePoint ; }
-
-    void subRevivals() { revivals-- ; }
-    void addRevivals() { revivals++ ; }
-    void addLives() { lives++ ; }
-    void subLives() { lives-- ; }
-    void addUpgradePoints() { upgradePoints++ ; }
-    void subUpgradePoints() { upgradePoints-- ; }
-    virtual void takeDamage() {
-        lives--;
-        battlefield->getLogger()->log(name + " is taking damage!\n") ;
-    }
-    void kill() { lives = 0 ; }
-    virtual void reset() { lives = 1 ; }
-
-    virtual ~Robot() = default;
-};
-
-class MovingRobot : virtual public Robot {
-public:
-    using Robot::Robot;
-    virtual void move(int dx, int dy) ;
-    virtual ~MovingRobot() = default;
-};
-
-class ShootingRobot : virtual public Robot {
-private:
-    int shells = 10 ;
-public:
-    using Robot::Robot;
-    virtual void fire(int dx, int dy) ;
-    int getShells() ;
-    void setShells(int shell) ;
-    void addShells() { shells++ ; }
-    void subShells() { shells-- ; }
-    virtual ~ShootingRobot() = default;
-};
-
-class SeeingRobot : virtual public Robot {
-public:
-    using Robot::Robot;
-    virtual void look(int dx, int dy) ;
-    virtual ~SeeingRobot() = default;
-};
-
-class ThinkingRobot : virtual public Robot {
-public:
-    using Robot::Robot;
-    virtual void think() ;
-    virtual ~ThinkingRobot() = default;
-};
-
-class GenericRobot : virtual public MovingRobot, virtual public ShootingRobot, virtual public SeeingRobot, virtual public ThinkingRobot {
-public:
-    GenericRobot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          MovingRobot(), ShootingRobot(), SeeingRobot(), ThinkingRobot() {}
-
-    void takeTurn() override ;
-    void reset() override ;
-
-};
-
-class HideBot : virtual public GenericRobot {                //override takeDamage()
-private:
-    int remainingHides = 3;
-public:
-    HideBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {}
-
-    bool canHide() ;
-    void takeDamage() override ;
-};
-
-class JumpBot : virtual public GenericRobot {       //override move()
-private:
-    int remainingJumps = 3;
-
-public:
-    JumpBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {}
-
-    void move(int dx, int dy) override ;
-
-    bool canJump() ;
-};
-
-class JuggernautBot : virtual public GenericRobot {
-private:
-    std::string directions[4] = {"up" , "down" , "left" , "right"} ;
-
-public:
-    JuggernautBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {}
-
-    void move(int dx, int dy) override ;
-};
-
-class TrueDamageBot : virtual public GenericRobot {
-public:
-    TrueDamageBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {
-        setType("TrueDamageBot") ;
-    }
-
-    void fire(int dx, int dy) override ;
-};
-
-class LifestealBot : virtual public GenericRobot {
-public:
-    LifestealBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {
-        setType("LifestealBot") ;
-    }
-
-    void fire(int dx, int dy) override ;
-};
-
-class LongshotBot : virtual public GenericRobot {
-public:
-    LongshotBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {
-        setType("LongshotBot") ;
-    }
-
-    void fire(int dx, int dy) override ;
-};
-
-class ThirtyshotBot : virtual public GenericRobot {
-public:
-    ThirtyshotBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {
-        setShells(30);         // replace current shell count with 30
-    }
-};
-
-class SemiautoBot : virtual public GenericRobot {
-public:
-    SemiautoBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {
-        setType("SemiautoBot") ;
-    }
-
-    void fire(int dx, int dy) override ;
-};
-
-class ScoutBot : virtual public GenericRobot {
-private:
-    int remainingScans = 3 ;
-public:
-    ScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {
-        setType("ScoutBot") ;
-    }
-
-    void look(int dx, int dy) override ;
-};
-
-class TrackerBot : virtual public GenericRobot {
-private:
-    int remainingTracker = 3 ;
-    std::vector<std::string> trackedRobotName ;
-public:
-    TrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf) {
-        setType("TrackerBot") ;
-    }
-
-    void look(int dx, int dy) override ;
-};
-
-class HideLongshotBot : virtual public HideBot, virtual public LongshotBot {
-public:
-    HideLongshotBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), HideBot(type, name, x, y, bf), LongshotBot(type, name, x, y, bf) {
-        setType("HideLongshotBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class HideSemiautoBot : virtual public HideBot, virtual public SemiautoBot {
-public:
-    HideSemiautoBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), HideBot(type, name, x, y, bf), SemiautoBot(type, name, x, y, bf) {
-        setType("HideSemiautoBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class HideThirtyshotBot : virtual public HideBot, virtual public ThirtyshotBot {
-public:
-    HideThirtyshotBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), HideBot(type, name, x, y, bf), ThirtyshotBot(type, name, x, y, bf) {
-        setType("HideThirtyshotBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class HideTrueDamageBot : virtual public HideBot, virtual public TrueDamageBot {
-public:
-    HideTrueDamageBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), HideBot(type, name, x, y, bf), TrueDamageBot(type, name, x, y, bf) {
-        setType("HideTrueDamageBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class HideLifestealBot : virtual public HideBot, virtual public LifestealBot {
-public:
-    HideLifestealBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), HideBot(type, name, x, y, bf), LifestealBot(type, name, x, y, bf) {
-        setType("HideLifestealBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JumpLongshotBot : virtual public JumpBot, virtual public LongshotBot {
-public:
-    JumpLongshotBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JumpBot(type, name, x, y, bf), LongshotBot(type, name, x, y, bf) {
-        setType("JumpLongshotBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JumpSemiautoBot : virtual public JumpBot, virtual public SemiautoBot {
-public:
-    JumpSemiautoBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JumpBot(type, name, x, y, bf), SemiautoBot(type, name, x, y, bf) {
-        setType("JumpSemiautoBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JumpThirtyshotBot : virtual public JumpBot, virtual public ThirtyshotBot {
-public:
-    JumpThirtyshotBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JumpBot(type, name, x, y, bf), ThirtyshotBot(type, name, x, y, bf) {
-        setType("JumpThirtyshotBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JumpTrueDamageBot : virtual public JumpBot, virtual public TrueDamageBot {
-public:
-    JumpTrueDamageBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JumpBot(type, name, x, y, bf), TrueDamageBot(type, name, x, y, bf) {
-        setType("JumpTrueDamageBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JumpLifestealBot : virtual public JumpBot, virtual public LifestealBot {
-public:
-    JumpLifestealBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JumpBot(type, name, x, y, bf), LifestealBot(type, name, x, y, bf) {
-        setType("JumpLifestealBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JuggernautLongshotBot : virtual public JuggernautBot, virtual public LongshotBot {
-public:
-    JuggernautLongshotBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JuggernautBot(type, name, x, y, bf), LongshotBot(type, name, x, y, bf) {
-        setType("JuggernautLongshotBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JuggernautSemiautoBot : virtual public JuggernautBot, virtual public SemiautoBot {
-public:
-    JuggernautSemiautoBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JuggernautBot(type, name, x, y, bf), SemiautoBot(type, name, x, y, bf) {
-        setType("JuggernautSemiautoBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JuggernautThirtyshotBot : virtual public JuggernautBot, virtual public ThirtyshotBot {
-public:
-    JuggernautThirtyshotBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JuggernautBot(type, name, x, y, bf), ThirtyshotBot(type, name, x, y, bf) {
-        setType("JuggernautThirtyshotBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JuggernautTrueDamageBot : virtual public JuggernautBot, virtual public TrueDamageBot {
-public:
-    JuggernautTrueDamageBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JuggernautBot(type, name, x, y, bf), TrueDamageBot(type, name, x, y, bf) {
-        setType("JuggernautTrueDamageBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JuggernautLifestealBot : virtual public JuggernautBot, virtual public LifestealBot {
-public:
-    JuggernautLifestealBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf), GenericRobot(type, name, x, y, bf), JuggernautBot(type, name, x, y, bf), LifestealBot(type, name, x, y, bf) {
-        setType("JuggernautLifestealBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class HideLongshotScoutBot : virtual public HideLongshotBot, virtual public ScoutBot {
-public:
-    HideLongshotScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          HideBot(type, name, x, y, bf),
-          LongshotBot(type, name, x, y, bf),
-          HideLongshotBot(type, name, x, y, bf),
-          ScoutBot(type, name, x, y, bf) {
-        setType("HideLongshotScoutBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class HideLongshotTrackerBot : virtual public HideLongshotBot, virtual public TrackerBot {
-public:
-    HideLongshotTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          HideBot(type, name, x, y, bf),
-          LongshotBot(type, name, x, y, bf),
-          HideLongshotBot(type, name, x, y, bf),
-          TrackerBot(type, name, x, y, bf) {
-        setType("HideLongshotTrackerBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class HideSemiautoScoutBot : virtual public HideSemiautoBot, virtual public ScoutBot {
-public:
-    HideSemiautoScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          HideBot(type, name, x, y, bf),
-          SemiautoBot(type, name, x, y, bf),
-          HideSemiautoBot(type, name, x, y, bf),
-          ScoutBot(type, name, x, y, bf) {
-        setType("HideSemiautoScoutBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class HideSemiautoTrackerBot : virtual public HideSemiautoBot, virtual public TrackerBot {
-public:
-    HideSemiautoTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          HideBot(type, name, x, y, bf),
-          SemiautoBot(type, name, x, y, bf),
-          HideSemiautoBot(type, name, x, y, bf),
-          TrackerBot(type, name, x, y, bf) {
-        setType("HideSemiautoTrackerBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class HideThirtyshotScoutBot : virtual public HideThirtyshotBot, virtual public ScoutBot {
-public:
-    HideThirtyshotScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          HideBot(type, name, x, y, bf),
-          ThirtyshotBot(type, name, x, y, bf),
-          HideThirtyshotBot(type, name, x, y, bf),
-          ScoutBot(type, name, x, y, bf) {
-        setType("HideThirtyshotScoutBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class HideThirtyshotTrackerBot : virtual public HideThirtyshotBot, virtual public TrackerBot {
-public:
-    HideThirtyshotTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          HideBot(type, name, x, y, bf),
-          ThirtyshotBot(type, name, x, y, bf),
-          HideThirtyshotBot(type, name, x, y, bf),
-          TrackerBot(type, name, x, y, bf) {
-        setType("HideThirtyshotTrackerBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class HideTrueDamageScoutBot : virtual public HideTrueDamageBot, virtual public ScoutBot {
-public:
-    HideTrueDamageScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          HideBot(type, name, x, y, bf),
-          TrueDamageBot(type, name, x, y, bf),
-          HideTrueDamageBot(type, name, x, y, bf),
-          ScoutBot(type, name, x, y, bf) {
-        setType("HideTrueDamageScoutBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class HideTrueDamageTrackerBot : virtual public HideTrueDamageBot, virtual public TrackerBot {
-public:
-    HideTrueDamageTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          HideBot(type, name, x, y, bf),
-          TrueDamageBot(type, name, x, y, bf),
-          HideTrueDamageBot(type, name, x, y, bf),
-          TrackerBot(type, name, x, y, bf) {
-        setType("HideTrueDamageTrackerBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class HideLifestealScoutBot : virtual public HideLifestealBot, virtual public ScoutBot {
-public:
-    HideLifestealScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          HideBot(type, name, x, y, bf),
-          LifestealBot(type, name, x, y, bf),
-          HideLifestealBot(type, name, x, y, bf),
-          ScoutBot(type, name, x, y, bf) {
-        setType("HideLifestealScoutBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class HideLifestealTrackerBot : virtual public HideLifestealBot, virtual public TrackerBot {
-public:
-    HideLifestealTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          HideBot(type, name, x, y, bf),
-          LifestealBot(type, name, x, y, bf),
-          HideLifestealBot(type, name, x, y, bf),
-          TrackerBot(type, name, x, y, bf) {
-        setType("HideLifestealTrackerBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JumpLongshotScoutBot : virtual public JumpLongshotBot, virtual public ScoutBot {
-public:
-    JumpLongshotScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JumpBot(type, name, x, y, bf),
-          LongshotBot(type, name, x, y, bf),
-          JumpLongshotBot(type, name, x, y, bf),
-          ScoutBot(type, name, x, y, bf) {
-        setType("JumpLongshotScoutBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JumpLongshotTrackerBot : virtual public JumpLongshotBot, virtual public TrackerBot {
-public:
-    JumpLongshotTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JumpBot(type, name, x, y, bf),
-          LongshotBot(type, name, x, y, bf),
-          JumpLongshotBot(type, name, x, y, bf),
-          TrackerBot(type, name, x, y, bf) {
-        setType("JumpLongshotTrackerBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JumpSemiautoScoutBot : virtual public JumpSemiautoBot, virtual public ScoutBot {
-public:
-    JumpSemiautoScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JumpBot(type, name, x, y, bf),
-          SemiautoBot(type, name, x, y, bf),
-          JumpSemiautoBot(type, name, x, y, bf),
-          ScoutBot(type, name, x, y, bf) {
-        setType("JumpSemiautoScoutBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JumpSemiautoTrackerBot : virtual public JumpSemiautoBot, virtual public TrackerBot {
-public:
-    JumpSemiautoTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JumpBot(type, name, x, y, bf),
-          SemiautoBot(type, name, x, y, bf),
-          JumpSemiautoBot(type, name, x, y, bf),
-          TrackerBot(type, name, x, y, bf) {
-        setType("JumpSemiautoTrackerBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JumpThirtyshotScoutBot : virtual public JumpThirtyshotBot, virtual public ScoutBot {
-public:
-    JumpThirtyshotScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JumpBot(type, name, x, y, bf),
-          ThirtyshotBot(type, name, x, y, bf),
-          JumpThirtyshotBot(type, name, x, y, bf),
-          ScoutBot(type, name, x, y, bf) {
-        setType("JumpThirtyshotScoutBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JumpThirtyshotTrackerBot : virtual public JumpThirtyshotBot, virtual public TrackerBot {
-public:
-    JumpThirtyshotTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JumpBot(type, name, x, y, bf),
-          ThirtyshotBot(type, name, x, y, bf),
-          JumpThirtyshotBot(type, name, x, y, bf),
-          TrackerBot(type, name, x, y, bf) {
-        setType("JumpThirtyshotTrackerBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JumpTrueDamageScoutBot : virtual public JumpTrueDamageBot, virtual public ScoutBot {
-public:
-    JumpTrueDamageScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JumpBot(type, name, x, y, bf),
-          TrueDamageBot(type, name, x, y, bf),
-          JumpTrueDamageBot(type, name, x, y, bf),
-          ScoutBot(type, name, x, y, bf) {
-        setType("JumpTrueDamageScoutBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JumpTrueDamageTrackerBot : virtual public JumpTrueDamageBot, virtual public TrackerBot {
-public:
-    JumpTrueDamageTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JumpBot(type, name, x, y, bf),
-          TrueDamageBot(type, name, x, y, bf),
-          JumpTrueDamageBot(type, name, x, y, bf),
-          TrackerBot(type, name, x, y, bf) {
-        setType("JumpTrueDamageTrackerBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JumpLifestealScoutBot : virtual public JumpLifestealBot, virtual public ScoutBot {
-public:
-    JumpLifestealScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JumpBot(type, name, x, y, bf),
-          LifestealBot(type, name, x, y, bf),
-          JumpLifestealBot(type, name, x, y, bf),
-          ScoutBot(type, name, x, y, bf) {
-        setType("JumpLifestealScoutBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JumpLifestealTrackerBot : virtual public JumpLifestealBot, virtual public TrackerBot {
-public:
-    JumpLifestealTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JumpBot(type, name, x, y, bf),
-          LifestealBot(type, name, x, y, bf),
-          JumpLifestealBot(type, name, x, y, bf),
-          TrackerBot(type, name, x, y, bf) {
-        setType("JumpLifestealTrackerBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JuggernautLongshotScoutBot : virtual public JuggernautLongshotBot, virtual public ScoutBot {
-public:
-    JuggernautLongshotScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JuggernautBot(type, name, x, y, bf),
-          LongshotBot(type, name, x, y, bf),
-          JuggernautLongshotBot(type, name, x, y, bf),
-          ScoutBot(type, name, x, y, bf) {
-        setType("JuggernautLongshotScoutBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JuggernautLongshotTrackerBot : virtual public JuggernautLongshotBot, virtual public TrackerBot {
-public:
-    JuggernautLongshotTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JuggernautBot(type, name, x, y, bf),
-          LongshotBot(type, name, x, y, bf),
-          JuggernautLongshotBot(type, name, x, y, bf),
-          TrackerBot(type, name, x, y, bf) {
-        setType("JuggernautLongshotTrackerBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JuggernautSemiautoScoutBot : virtual public JuggernautSemiautoBot, virtual public ScoutBot {
-public:
-    JuggernautSemiautoScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JuggernautBot(type, name, x, y, bf),
-          SemiautoBot(type, name, x, y, bf),
-          JuggernautSemiautoBot(type, name, x, y, bf),
-          ScoutBot(type, name, x, y, bf) {
-        setType("JuggernautSemiautoScoutBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JuggernautSemiautoTrackerBot : virtual public JuggernautSemiautoBot, virtual public TrackerBot {
-public:
-    JuggernautSemiautoTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JuggernautBot(type, name, x, y, bf),
-          SemiautoBot(type, name, x, y, bf),
-          JuggernautSemiautoBot(type, name, x, y, bf),
-          TrackerBot(type, name, x, y, bf) {
-        setType("JuggernautSemiautoTrackerBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JuggernautThirtyshotScoutBot : virtual public JuggernautThirtyshotBot, virtual public ScoutBot {
-public:
-    JuggernautThirtyshotScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JuggernautBot(type, name, x, y, bf),
-          ThirtyshotBot(type, name, x, y, bf),
-          JuggernautThirtyshotBot(type, name, x, y, bf),
-          ScoutBot(type, name, x, y, bf) {
-        setType("JuggernautThirtyshotScoutBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JuggernautThirtyshotTrackerBot : virtual public JuggernautThirtyshotBot, virtual public TrackerBot {
-public:
-    JuggernautThirtyshotTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JuggernautBot(type, name, x, y, bf),
-          ThirtyshotBot(type, name, x, y, bf),
-          JuggernautThirtyshotBot(type, name, x, y, bf),
-          TrackerBot(type, name, x, y, bf) {
-        setType("JuggernautThirtyshotTrackerBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JuggernautTrueDamageScoutBot : virtual public JuggernautTrueDamageBot, virtual public ScoutBot {
-public:
-    JuggernautTrueDamageScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JuggernautBot(type, name, x, y, bf),
-          TrueDamageBot(type, name, x, y, bf),
-          JuggernautTrueDamageBot(type, name, x, y, bf),
-          ScoutBot(type, name, x, y, bf) {
-        setType("JuggernautTrueDamageScoutBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JuggernautTrueDamageTrackerBot : virtual public JuggernautTrueDamageBot, virtual public TrackerBot {
-public:
-    JuggernautTrueDamageTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JuggernautBot(type, name, x, y, bf),
-          TrueDamageBot(type, name, x, y, bf),
-          JuggernautTrueDamageBot(type, name, x, y, bf),
-          TrackerBot(type, name, x, y, bf) {
-        setType("JuggernautTrueDamageTrackerBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JuggernautLifestealScoutBot : virtual public JuggernautLifestealBot, virtual public ScoutBot {
-public:
-    JuggernautLifestealScoutBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JuggernautBot(type, name, x, y, bf),
-          LifestealBot(type, name, x, y, bf),
-          JuggernautLifestealBot(type, name, x, y, bf),
-          ScoutBot(type, name, x, y, bf) {
-        setType("JuggernautLifestealScoutBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
-
-class JuggernautLifestealTrackerBot : virtual public JuggernautLifestealBot, virtual public TrackerBot {
-public:
-    JuggernautLifestealTrackerBot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf)
-        : Robot(type, name, x, y, bf),
-          GenericRobot(type, name, x, y, bf),
-          JuggernautBot(type, name, x, y, bf),
-          LifestealBot(type, name, x, y, bf),
-          JuggernautLifestealBot(type, name, x, y, bf),
-          TrackerBot(type, name, x, y, bf) {
-        setType("JuggernautLifestealTrackerBot") ;
-    }
-
-    //no need to override anything because there's no ambiguity, because no overlapping functions between seeing shooting moving.
-};
+#include "Battlefield.h"
 
 /*Starting from here is all of the full functions
 xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
@@ -886,51 +11,57 @@ void MovingRobot::move(int dx, int dy) {
     if(dx == 0 && dy == 0)
         return ;
 
+    if(wade())
+        return ;
+
     int newX = getX() + dx;
     int newY = getY() + dy;
 
-    battlefield->getLogger()->log(getName() + " want to move to (" + std::to_string(newX) + "," + std::to_string(newY) + ")\n") ;
+    battlefield->getLogger()->log(getName(), " want to move to (", newX, ",", newY, ")\n") ;
 
-    if(battlefield->isInside(newX, newY) && !battlefield->isOccupied(newX, newY)) {
+    if(battlefield->canEnter(newX, newY)) {
         setPosition(newX, newY) ;
 
-        battlefield->getLogger()->log(getName() + " moves to (" + std::to_string(getX()) + ", " + std::to_string(getY()) + ")\n") ;
+        battlefield->getLogger()->log(getName(), " moves to (", getX(), ", ", getY(), ")\n") ;
     }
     else {
-        battlefield->getLogger()->log("Cannot move to (" + std::to_string(newX) + "," + std::to_string(newY) + ") : Invalid Position\n") ;
+        battlefield->getLogger()->log("Cannot move to (", newX, ",", newY, ") : Invalid Position\n") ;
     }
 }
 
+bool MovingRobot::wade() {
+    if(!wading && battlefield->getTerrain().isSlow(getX(), getY())) {
+        wading = true ;
+        battlefield->getLogger()->log(getName(), " is wading through slow terrain\n") ;
+        return true ;
+    }
+    wading = false ;
+    return false ;
+}
+
 void ShootingRobot::fire(int dx, int dy) {
     if ((dx == 0 && dy == 0))
         return;
 
     if(shells > 0) {
-        shells--;
+        subShells() ;
 
         int targetX = getX() + dx;
         int targetY = getY() + dy;
 
-        if (!battlefield->isInside(targetX, targetY)) {                     //only shoot inside the battlefield area
-            battlefield->getLogger()->log(getName() + " tried to fire outside the battlefield.\n") ;
+        if (!battlefield->canShoot(this, targetX, targetY))                //only shoot inside the battlefield area
             return;
-        }
-
-        battlefield->getLogger()->log(getName() + " fires at (" + std::to_string(targetX) + ", " + std::to_string(targetY) + ")\n") ;
 
-        for (Robot* other : battlefield->getRobots()) {                            //check if there is robot there
-            if (other->isAlive() && other->getX() == targetX && other->getY() == targetY) {
+        battlefield->getLogger()->log(getName(), " fires at (", targetX, ", ", targetY, ")\n") ;
 
-                battlefield->getLogger()->log(getName() + " hits " + other->getName() + "!\n") ;
-                other->takeDamage();     //other robot take damage
-                addUpgradePoints() ;     //this robot get 1 upgrade point
-
-                break; // Only one robot can be at a position
-            }
+        if (Robot* other = battlefield->robotAt(targetX, targetY, team)) {         //check if there is an enemy robot there
+            battlefield->getLogger()->log(getName(), " hits ", other->getName(), "!\n") ;
+            other->takeDamage();     //other robot take damage
+            addUpgradePoints() ;     //this robot get 1 upgrade point
         }
     }
     else {
-        battlefield->getLogger()->log(getName() + " is out of shells and self-destructs!\n") ;
+        battlefield->getLogger()->log(getName(), " is out of shells and self-destructs!\n") ;
         kill();
     }
 }
@@ -940,17 +71,41 @@ int ShootingRobot::getShells() {
 }
 
 void ShootingRobot::setShells(int shell) {
-    shells = shell ;
+    setState(shells, shell, STATE_SHELLS) ;
+}
+
+bool SeeingRobot::teamLook(std::pmr::vector<Robot*>* found) {
+    if(team == 0 || !battlefield->hasTeams())
+        return false ;
+    battlefield->noteAction(ACTION_LOOK, this) ;
+
+    std::pmr::vector<int> cells(battlefield->getArena()) ;
+    int enemies = battlefield->getVisibility().visibleEnemies(team, cells, 3) ;
+    battlefield->getLogger()->log(getName(), " sees ", enemies, " enemies through team ", team, "\n") ;
+    for(int cell : cells) {
+        Robot* other = battlefield->robotAt(cell % battlefield->getCols(), cell / battlefield->getCols(), team) ;
+        if(other) {
+            battlefield->getLogger()->log(getName(), " found ", other->getName(), " at (", other->getX(), ",", other->getY(), ")\n") ;
+            if(found)
+                found->push_back(other) ;
+        }
+    }
+    return true ;
 }
 
 void SeeingRobot::look(int dx, int dy) {
+    if(teamLook())                                       //team robots report what the whole team sees this step
+        return ;
+
     int targetX = getX() + dx ;
     int targetY = getY() + dy ;
 
     if(!battlefield->isInside(targetX, targetY))
         return ;
 
-    std::vector<std::pair<int,int>> lookAreas ;
+    battlefield->noteAction(ACTION_LOOK, this) ;
+
+    std::pmr::vector<std::pair<int,int>> lookAreas(battlefield->getArena()) ;
 
     for (int dx = -1; dx <= 1; ++dx) {
         for (int dy = -1; dy <= 1; ++dy) {
@@ -962,40 +117,95 @@ void SeeingRobot::look(int dx, int dy) {
         }
     }
 
-    battlefield->getLogger()->log(getName() + " is looking at (" + std::to_string(targetX) + ", " + std::to_string(targetY) + ")\n") ;
-
+    battlefield->getLogger()->log(getName(), " is looking at (", targetX, ", ", targetY, ")\n") ;
+    if(!battlefield->mayHaveRobotAround(targetX, targetY, this))
+        return ;
 
     for(Robot* other : battlefield->getRobots()) {
         for(std::pair<int,int>& lookArea : lookAreas) {
             if(other && other != this && other->isAlive() && other->getX() == lookArea.first && other->getY() == lookArea.second) {
-                battlefield->getLogger()->log(getName() + " found " + other->getName() + " at (" + std::to_string(other->getX()) + "," + std::to_string(other->getY()) + ")\n") ;
+                battlefield->getLogger()->log(getName(), " found ", other->getName(), " at (", other->getX(), ",", other->getY(), ")\n") ;
             }
         }
     }
 }
 
 void ThinkingRobot::think() {
-    battlefield->getLogger()->log(getName() + " is thinking about its next move.\n") ;
+    hasTarget = false ;
+    if(battlefield->getAiMode() != AI_RANDOM) {
+        if(Robot* target = battlefield->getSpatialIndex().nearest(getX(), getY(), this, getTeam())) {
+            hasTarget = true ;
+            targetX = target->getX() ;
+            targetY = target->getY() ;
+            battlefield->getLogger()->log(getName(), " targets ", target->getName(), " at (", targetX, ",", targetY, ")\n") ;
+            return ;
+        }
+    }
+    battlefield->getLogger()->log(getName(), " is thinking about its next move.\n") ;
+}
+
+static int stepToward(int from, int to) { return (to > from) - (to < from) ; }
+
+void ThinkingRobot::aimLook(int& dx, int& dy) const {
+    if(!hasTarget)
+        return ;
+    dx = stepToward(getX(), targetX) ;
+    dy = stepToward(getY(), targetY) ;
+}
+
+void ThinkingRobot::aimFire(int& dx, int& dy) const {      //only shoot when the target is next to us, shells are scarce
+    if(!hasTarget)
+        return ;
+    bool adjacent = std::abs(targetX - getX()) <= 1 && std::abs(targetY - getY()) <= 1 ;
+    dx = adjacent ? targetX - getX() : 0 ;
+    dy = adjacent ? targetY - getY() : 0 ;
+}
+
+void ThinkingRobot::aimMove(int& dx, int& dy) const {      //close in, but stay put once adjacent
+    if(battlefield->getAiMode() == AI_FLOW) {
+        if(!battlefield->flowStep(this, dx, dy))
+            dx = dy = 0 ;
+        return ;
+    }
+    if(!hasTarget)
+        return ;
+    if(std::abs(targetX - getX()) <= 1 && std::abs(targetY - getY()) <= 1) {
+        dx = dy = 0 ;
+        return ;
+    }
+    dx = stepToward(getX(), targetX) ;
+    dy = stepToward(getY(), targetY) ;
 }
 
 void GenericRobot::takeTurn() {
+    takeTurnDirect<GenericRobot, false>(this) ;          //subclasses override the abilities, so keep the calls virtual
+}
+
+template<class T, bool Bound> void GenericRobot::takeTurnDirect(T* self) {    //Bound = false : plain virtual calls
+    if(const ScriptProgram* program = self->getScript()) {
+        program->run(*self) ;
+        return ;
+    }
 
-    think() ;
+    if constexpr(Bound) self->T::think() ; else self->think() ;
 
-    int dx = rand() % 3 - 1;
-    int dy = rand() % 3 - 1;
+    int dx = self->roll() % 3 - 1;
+    int dy = self->roll() % 3 - 1;
+    self->aimLook(dx, dy) ;
 
-    look(dx, dy);
+    if constexpr(Bound) self->T::look(dx, dy) ; else self->look(dx, dy) ;
 
-    dx = rand() % 3 - 1;
-    dy = rand() % 3 - 1;
+    dx = self->roll() % 3 - 1;
+    dy = self->roll() % 3 - 1;
+    self->aimFire(dx, dy) ;
 
-    fire(dx, dy);
+    if constexpr(Bound) self->T::fire(dx, dy) ; else self->fire(dx, dy) ;
 
-    dx = rand() % 3 - 1;
-    dy = rand() % 3 - 1;
+    dx = self->roll() % 3 - 1;
+    dy = self->roll() % 3 - 1;
+    self->aimMove(dx, dy) ;
 
-    move(dx, dy);
+    if constexpr(Bound) self->T::move(dx, dy) ; else self->move(dx, dy) ;
 }
 
 void GenericRobot::reset() {
@@ -1004,340 +214,363 @@ void GenericRobot::reset() {
     //setUpgradePoints(0) ;  //if reset upgradePoints every time revive, we might never see tier 3 robot
 }
 
-bool HideBot::canHide() {
-    return remainingHides > 0 ;
+void StepMove::move(GenericRobot& self, int dx, int dy) {
+    self.MovingRobot::move(dx, dy) ;
+}
+
+void StepMove::takeDamage(GenericRobot& self) {
+    self.Robot::takeDamage() ;
+}
+
+const std::string JuggernautMove::directions[4] = {"up" , "down" , "left" , "right"} ;
+
+void BasicFire::fire(GenericRobot& self, int dx, int dy) {
+    self.ShootingRobot::fire(dx, dy) ;
+}
+
+void BasicLook::look(GenericRobot& self, int dx, int dy) {
+    self.SeeingRobot::look(dx, dy) ;
 }
 
-void HideBot::takeDamage() {
+void HideMove::takeDamage(GenericRobot& self) {
+    Battlefield* battlefield = self.getBattlefield() ;
+
     if(canHide()) {
         remainingHides--;
-        battlefield->getLogger()->log(getName() + " is hiding and avoid the hit (invulnerable). Hides left: " + std::to_string(remainingHides) + "\n") ;
+        battlefield->getLogger()->log(self.getName(), " is hiding and avoid the hit (invulnerable). Hides left: ", remainingHides, "\n") ;
         return ;
     }
     else {
-        subLives() ;
-        battlefield->getLogger()->log(getName() + " tried to hide but has no hides left! TAKING DAMAGE!\n") ;
+        battlefield->noteAction(ACTION_HIT, &self) ;     //only damage taken counts as a hit
+        self.subLives() ;
+        battlefield->getLogger()->log(self.getName(), " tried to hide but has no hides left! TAKING DAMAGE!\n") ;
     }
 }
 
-void JumpBot::move(int dx, int dy) {                 //changed from jump() to just overriding move()
+void JumpMove::move(GenericRobot& self, int dx, int dy) {         //changed from jump() to just overriding move()
+    Battlefield* battlefield = self.getBattlefield() ;
+    if(self.wade())
+        return ;
     if(canJump()) {
-        int newX = rand() % battlefield->getCols();       //random position inside the boundaries
-        int newY = rand() % battlefield->getRows();
+        int newX = self.roll() % battlefield->getCols();       //random position inside the boundaries
+        int newY = self.roll() % battlefield->getRows();
 
-        if(battlefield->isInside(newX, newY) && !battlefield->isOccupied(newX, newY)) {
+        if(battlefield->canEnter(newX, newY)) {
             remainingJumps--;
-            battlefield->getLogger()->log(getName() + " jumps from (" + std::to_string(getX()) + "," + std::to_string(getY())
-                                          + ") to (" + std::to_string(newX) + ", " + std::to_string(newY) + "). Jumps left: "
-                                          + std::to_string(remainingJumps) + "\n") ;
-            setPosition(newX, newY);
+            battlefield->getLogger()->log(self.getName(), " jumps from (", self.getX(), ",", self.getY(),
+                                           ") to (", newX, ", ", newY, "). Jumps left: ",
+                                           remainingJumps, "\n") ;
+            self.setPosition(newX, newY);
         }
         else {
-            battlefield->getLogger()->log(getName() + " tried to jump to (" + std::to_string(newX) + "," + std::to_string(newY)
-                                          + "). Invalid Position. No Jumps consumed.\n") ;
+            battlefield->getLogger()->log(self.getName(), " tried to jump to (", newX, ",", newY,
+                                           "). Invalid Position. No Jumps consumed.\n") ;
         }
     }
     else {
-        battlefield->getLogger()->log(getName() + " tried to jump but has no jumps left! Proceed with normal movement logic\n") ;
+        battlefield->getLogger()->log(self.getName(), " tried to jump but has no jumps left! Proceed with normal movement logic\n") ;
 
-        int newX = getX() + dx;
-        int newY = getY() + dy;
-        battlefield->getLogger()->log(getName() + " want to move to (" + std::to_string(newX) + "," + std::to_string(newY) + ")\n") ;
+        int newX = self.getX() + dx;
+        int newY = self.getY() + dy;
+        battlefield->getLogger()->log(self.getName(), " want to move to (", newX, ",", newY, ")\n") ;
 
-        if(battlefield->isInside(newX, newY) && !battlefield->isOccupied(newX, newY)) {
-            setPosition(newX , newY) ;
-            battlefield->getLogger()->log(getName() + " moves to (" + std::to_string(getX()) + ", " + std::to_string(getY()) + ")\n") ;
+        if(battlefield->canEnter(newX, newY)) {
+            self.setPosition(newX , newY) ;
+            battlefield->getLogger()->log(self.getName(), " moves to (", self.getX(), ", ", self.getY(), ")\n") ;
         }
         else {
-            battlefield->getLogger()->log("Cannot move to (" + std::to_string(newX) + "," + std::to_string(newY) + ") : Invalid Position\n") ;
+            battlefield->getLogger()->log("Cannot move to (", newX, ",", newY, ") : Invalid Position\n") ;
         }
     }
 }
 
-bool JumpBot::canJump() {
-    return remainingJumps > 0 ;
-}
+void JuggernautMove::move(GenericRobot& self, int dx, int dy) {
+    Battlefield* battlefield = self.getBattlefield() ;
+    if(self.wade())                                      //a charge stops on slow ground, and starts off it a turn late
+        return ;
 
-void JuggernautBot::move(int dx, int dy) {
-    int idxDirection = rand() % 4 ;               //randomize direction
-    int oldY = getY() ;
-    int oldX = getX() ;                             //for display purposes
+    int idxDirection = self.roll() % 4 ;               //randomize direction
+    int oldY = self.getY() ;
+    int oldX = self.getX() ;                             //for display purposes
 
     if(directions[idxDirection] == "up") {
-        if(getY() == 0) {
+        if(self.getY() == 0) {
             battlefield->getLogger()->log("At the edge, Cannot move up. Skipping Move.\n") ;
             return ;
         }
 
-        dy = rand() % getY() ;                //valid dy to move
+        dy = self.roll() % self.getY() ;                //valid dy to move
+        dy = battlefield->chargeLength(oldX, oldY, 0, -1, dy) ;
+
+        self.setPosition(self.getX() , self.getY() - dy) ;           //x remain constant, y moving
 
-        setPosition(getX() , getY() - dy) ;           //x remain constant, y moving
+        battlefield->getLogger()->log(self.getName(), " is charging through the line from (", oldX, ",", oldY, ") towards (",
+                                       self.getX(), ",", self.getY(), "). Dealing damage to all robot along the path\n") ;
 
-        battlefield->getLogger()->log(getName() + " is charging through the line from (" + std::to_string(oldX) + "," + std::to_string(oldY) + ") towards ("
-                                      + std::to_string(getX()) + "," + std::to_string(getY()) + "). Dealing damage to all robot along the path\n") ;
+        if(!battlefield->mayHaveRobotOnLine(oldX, oldY - dy, oldX, oldY - 1, &self))    //nobody on the path
+            return ;
 
         for(Robot* other : battlefield->getRobots()) {  //dealing damage along passed line
             for(int i = 1 ; i <= dy ; i++) {
-                if(other != this && other->isAlive() && other->getX() == oldX && other->getY() == (oldY - i)) {
+                if(other != &self && other->isAlive() && !self.isTeamMate(other) && other->getX() == oldX && other->getY() == (oldY - i)) {
                     other->takeDamage() ;
-                    addUpgradePoints() ;
+                    self.addUpgradePoints() ;
                 }
             }
         }
     }
     else if(directions[idxDirection] == "down") {
-        if(getY() == battlefield->getRows() - 1) {
+        if(self.getY() == battlefield->getRows() - 1) {
             battlefield->getLogger()->log("At the edge, Cannot move down. Skipping Move.\n") ;
             return ;
         }
 
-        dy = rand() % (battlefield->getRows() - getY()) ;
-        setPosition(getX() , getY() + dy) ;
+        dy = self.roll() % (battlefield->getRows() - self.getY()) ;
+        dy = battlefield->chargeLength(oldX, oldY, 0, 1, dy) ;
+        self.setPosition(self.getX() , self.getY() + dy) ;
 
-        battlefield->getLogger()->log(getName() + " is charging through the line from (" + std::to_string(oldX) + "," + std::to_string(oldY) + ") towards ("
-                                      + std::to_string(getX()) + "," + std::to_string(getY()) + "). Dealing damage to all robot along the path\n") ;
+        battlefield->getLogger()->log(self.getName(), " is charging through the line from (", oldX, ",", oldY, ") towards (",
+                                       self.getX(), ",", self.getY(), "). Dealing damage to all robot along the path\n") ;
+
+        if(!battlefield->mayHaveRobotOnLine(oldX, oldY + 1, oldX, oldY + dy, &self))    //nobody on the path
+            return ;
 
         for(Robot* other : battlefield->getRobots()) {
             for(int i = 1 ; i <= dy ; i++) {
-                if(other != this && other->isAlive() && other->getX() == oldX && other->getY() == (oldY + i)) {
+                if(other != &self && other->isAlive() && !self.isTeamMate(other) && other->getX() == oldX && other->getY() == (oldY + i)) {
                     other->takeDamage() ;
-                    addUpgradePoints() ;
+                    self.addUpgradePoints() ;
                 }
             }
         }
     }
     else if(directions[idxDirection] == "left") {
-        if(getX() == 0) {
+        if(self.getX() == 0) {
             battlefield->getLogger()->log("At the edge, Cannot move left. Skipping Move.\n") ;
             return ;
         }
 
 
-        dx = rand() % (getX() - 0) ;
+        dx = self.roll() % (self.getX() - 0) ;
+        dx = battlefield->chargeLength(oldX, oldY, -1, 0, dx) ;
+
+        self.setPosition(self.getX() - dx , self.getY()) ;           //y remain constact, x moving
 
-        setPosition(getX() - dx , getY()) ;           //y remain constact, x moving
+        battlefield->getLogger()->log(self.getName(), " is charging through the line from (", oldX, ",", oldY, ") towards (",
+                                       self.getX(), ",", self.getY(), "). Dealing damage to all robot along the path\n") ;
 
-        battlefield->getLogger()->log(getName() + " is charging through the line from (" + std::to_string(oldX) + "," + std::to_string(oldY) + ") towards ("
-                                      + std::to_string(getX()) + "," + std::to_string(getY()) + "). Dealing damage to all robot along the path\n") ;
+        if(!battlefield->mayHaveRobotOnLine(oldX - dx, oldY, oldX - 1, oldY, &self))    //nobody on the path
+            return ;
 
         for(Robot* other : battlefield->getRobots()) {
             for(int i = 1 ; i <= dx ; i++) {
-                if(other != this && other->isAlive() && other->getX() == (oldX - i) && other->getY() == oldY) {
+                if(other != &self && other->isAlive() && !self.isTeamMate(other) && other->getX() == (oldX - i) && other->getY() == oldY) {
                     other->takeDamage() ;
-                    addUpgradePoints() ;
+                    self.addUpgradePoints() ;
                 }
             }
         }
     }
     else if(directions[idxDirection] == "right") {
-        if(getX() == battlefield->getCols() - 1) {
+        if(self.getX() == battlefield->getCols() - 1) {
             battlefield->getLogger()->log("At the edge, Cannot move right. Skipping Move.\n") ;
             return ;
         }
 
 
-        dx = rand() % (battlefield->getCols() - getX()) ;
-        setPosition(getX() + dx , getY()) ;
+        dx = self.roll() % (battlefield->getCols() - self.getX()) ;
+        dx = battlefield->chargeLength(oldX, oldY, 1, 0, dx) ;
+        self.setPosition(self.getX() + dx , self.getY()) ;
+
+        battlefield->getLogger()->log(self.getName(), " is charging through the line from (", oldX, ",", oldY, ") towards (",
+                                       self.getX(), ",", self.getY(), "). Dealing damage to all robot along the path\n") ;
 
-        battlefield->getLogger()->log(getName() + " is charging through the line from (" + std::to_string(oldX) + "," + std::to_string(oldY) + ") towards ("
-                                      + std::to_string(getX()) + "," + std::to_string(getY()) + "). Dealing damage to all robot along the path\n") ;
+        if(!battlefield->mayHaveRobotOnLine(oldX + 1, oldY, oldX + dx, oldY, &self))    //nobody on the path
+            return ;
 
         for(Robot* other : battlefield->getRobots()) {
             for(int i = 1 ; i <= dx ; i++) {
-                if(other != this && other->isAlive() && other->getX() == (oldX + i) && other->getY() == oldY) {
+                if(other != &self && other->isAlive() && !self.isTeamMate(other) && other->getX() == (oldX + i) && other->getY() == oldY) {
                     other->takeDamage() ;
-                    addUpgradePoints() ;
+                    self.addUpgradePoints() ;
                 }
             }
         }
     }
 }
 
-void TrueDamageBot::fire(int dx, int dy) {
+void TrueDamageFire::fire(GenericRobot& self, int dx, int dy) {
+    Battlefield* battlefield = self.getBattlefield() ;
+
     if (dx == 0 && dy == 0) return;
 
-    if(getShells() > 0) {
-        subShells() ;
+    if(self.getShells() > 0) {
+        self.subShells() ;
 
-        int targetX = getX() + dx;
-        int targetY = getY() + dy;
+        int targetX = self.getX() + dx;
+        int targetY = self.getY() + dy;
 
-        if (!battlefield->isInside(targetX, targetY)) {
-            battlefield->getLogger()->log(getName() + " tried to fire outside the battlefield.\n") ;
+        if (!battlefield->canShoot(&self, targetX, targetY))
             return;
-        }
-
-        battlefield->getLogger()->log(getName() + " fires at (" + std::to_string(targetX) + ", " + std::to_string(targetY) + ")\n") ;
-
-        for (Robot* other : battlefield->getRobots()) {
-            if (other != this && other->isAlive() && other->getX() == targetX && other->getY() == targetY) {
 
-                battlefield->getLogger()->log(name + " hits " + other->getName() + "!\n") ;
-                other->takeDamage();         //deal damage as usual
-                addUpgradePoints() ;         //get one upgrade point
+        battlefield->getLogger()->log(self.getName(), " fires at (", targetX, ", ", targetY, ")\n") ;
+        if (Robot* other = battlefield->robotAt(targetX, targetY, self.getTeam())) {
+            battlefield->getLogger()->log(self.getName(), " hits ", other->getName(), "!\n") ;
+            other->takeDamage();         //deal damage as usual
+            self.addUpgradePoints() ;         //get one upgrade point
 
-                if (rand() % 2 == 0) {       //50% chance to deal extra damage
-                    battlefield->getLogger()->log("True damage triggered, directly reducing " + other->getName() +  " revivals by 1\n") ;
-                    other->subRevivals() ;
-                }
-                break;
+            if (self.roll() % 2 == 0) {       //50% chance to deal extra damage
+                battlefield->getLogger()->log("True damage triggered, directly reducing ", other->getName(), " revivals by 1\n") ;
+                other->subRevivals() ;
             }
         }
     }
     else {
-        battlefield->getLogger()->log(name + " is out of shells and self-destructs!\n") ;
-        kill();
+        battlefield->getLogger()->log(self.getName(), " is out of shells and self-destructs!\n") ;
+        self.kill();
     }
 }
 
-void LifestealBot::fire(int dx, int dy) {
+void LifestealFire::fire(GenericRobot& self, int dx, int dy) {
+    Battlefield* battlefield = self.getBattlefield() ;
+
     if (dx == 0 && dy == 0) return;
 
-    if(getShells() > 0) {
-        subShells() ;
+    if(self.getShells() > 0) {
+        self.subShells() ;
 
-        int targetX = getX() + dx;
-        int targetY = getY() + dy;
+        int targetX = self.getX() + dx;
+        int targetY = self.getY() + dy;
 
-        if (!battlefield->isInside(targetX, targetY)) {
-            battlefield->getLogger()->log(name + " tried to fire outside the battlefield.\n") ;
+        if (!battlefield->canShoot(&self, targetX, targetY))
             return;
-        }
-
-        battlefield->getLogger()->log(name + " fires at (" + std::to_string(targetX) + ", " + std::to_string(targetY) + ")\n") ;
-
-        for (Robot* other : battlefield->getRobots()) {
-            if (other != this && other->isAlive() && other->getX() == targetX && other->getY() == targetY) {
 
-                battlefield->getLogger()->log(name + " hits " + other->getName() + "!\n") ;
-                other->takeDamage();         //deal damage as usual
-                addUpgradePoints() ;
+        battlefield->getLogger()->log(self.getName(), " fires at (", targetX, ", ", targetY, ")\n") ;
+        if (Robot* other = battlefield->robotAt(targetX, targetY, self.getTeam())) {
+            battlefield->getLogger()->log(self.getName(), " hits ", other->getName(), "!\n") ;
+            other->takeDamage();         //deal damage as usual
+            self.addUpgradePoints() ;
 
-                if (rand() % 2 == 0) {       //50% chance to absorb live
-                    battlefield->getLogger()->log("Lifesteal triggered, " + other->getName() +  " absorbs energy and gains 1 revival point!\n") ;
-                    other->addRevivals() ;
-                }
-                break;
+            if (self.roll() % 2 == 0) {       //50% chance to absorb live
+                battlefield->getLogger()->log("Lifesteal triggered, ", other->getName(), " absorbs energy and gains 1 revival point!\n") ;
+                other->addRevivals() ;
             }
         }
     }
     else {
-        battlefield->getLogger()->log(name + " is out of shells and self-destructs!\n") ;
-        kill();
+        battlefield->getLogger()->log(self.getName(), " is out of shells and self-destructs!\n") ;
+        self.kill();
     }
 }
 
-void LongshotBot::fire(int dx, int dy) {
+void LongshotFire::fire(GenericRobot& self, int dx, int dy) {
+    Battlefield* battlefield = self.getBattlefield() ;
+
     do {
-        dx = (rand() % 7) - 3;  // range: -3 to 3
-        dy = (rand() % 7) - 3;
+        dx = (self.roll() % 7) - 3;  // range: -3 to 3
+        dy = (self.roll() % 7) - 3;
     } while (std::abs(dx) + std::abs(dy) > 3 || (dx == 0 && dy == 0));  //loop until find valid position 3 units away
 
-    if(getShells() > 0) {
-        subShells() ;
+    if(self.getShells() > 0) {
+        self.subShells() ;
 
-        int targetX = getX() + dx;
-        int targetY = getY() + dy;
+        int targetX = self.getX() + dx;
+        int targetY = self.getY() + dy;
 
-        if (!battlefield->isInside(targetX, targetY)) {
-            battlefield->getLogger()->log(name + " tried to fire outside the battlefield.\n") ;
+        if (!battlefield->canShoot(&self, targetX, targetY))
             return;
-        }
-
-        battlefield->getLogger()->log(name + " fires at (" + std::to_string(targetX) + ", " + std::to_string(targetY) + ")\n") ;
-
-        for (Robot* other : battlefield->getRobots()) {
-            if (other != this && other->isAlive() && other->getX() == targetX && other->getY() == targetY) {
 
-                battlefield->getLogger()->log(name + " hits " + other->getName() + "!\n") ;
-                other->takeDamage();         //deal damage as usual
-                addUpgradePoints() ;
-                break;
-            }
+        battlefield->getLogger()->log(self.getName(), " fires at (", targetX, ", ", targetY, ")\n") ;
+        if (Robot* other = battlefield->robotAt(targetX, targetY, self.getTeam())) {
+            battlefield->getLogger()->log(self.getName(), " hits ", other->getName(), "!\n") ;
+            other->takeDamage();         //deal damage as usual
+            self.addUpgradePoints() ;
         }
     }
     else {
-        battlefield->getLogger()->log(name + " is out of shells and self-destructs!\n") ;
-        kill();
+        battlefield->getLogger()->log(self.getName(), " is out of shells and self-destructs!\n") ;
+        self.kill();
     }
 }
 
-void SemiautoBot::fire(int dx, int dy) {
+void SemiautoFire::fire(GenericRobot& self, int dx, int dy) {
+    Battlefield* battlefield = self.getBattlefield() ;
+
     if (dx == 0 && dy == 0) return;
 
-    int targetX = getX() + dx;
-    int targetY = getY() + dy;
+    int targetX = self.getX() + dx;
+    int targetY = self.getY() + dy;
 
-    if (!battlefield->isInside(targetX, targetY)) {
-            battlefield->getLogger()->log(name + " want to fire outside the battlefield. Skipping Fire.\n") ;
+    if(self.getShells() > 2) {
+        self.subShells() ;
+        self.subShells() ;
+        self.subShells() ;
+        if (!battlefield->canShoot(&self, targetX, targetY))      //the burst is spent either way, like a single shot
             return;
-    }
-
-    if(getShells() > 2) {
-        battlefield->getLogger()->log(name + " perform semi-auto fires at (" + std::to_string(targetX) + ", " + std::to_string(targetY) + ")\n") ;
-        subShells() ;
-        subShells() ;
-        subShells() ;
+        battlefield->getLogger()->log(self.getName(), " perform semi-auto fires at (", targetX, ", ", targetY, ")\n") ;
 
         for(int i = 1 ; i <= 3 ; i++) {
-            if ((rand() % 100) < 70) {                          // 70% hit chance
-                for (Robot* other : battlefield->getRobots()) {
-                    if (other != this && other->isAlive() && other->getX() == targetX && other->getY() == targetY) {
-
-                        battlefield->getLogger()->log(name + "'s shot #" + std::to_string(i) + " hits " + other->getName() + "!\n");
-                        other->takeDamage();
-                        addUpgradePoints() ;
-                        break ;
-                    }
+            if ((self.roll() % 100) < 70) {                          // 70% hit chance
+                if (Robot* other = battlefield->robotAt(targetX, targetY, self.getTeam())) {
+                    battlefield->getLogger()->log(self.getName(), "'s shot #", i, " hits ", other->getName(), "!\n");
+                    other->takeDamage();
+                    self.addUpgradePoints() ;
                 }
             }
             else {
-                battlefield->getLogger()->log(name + "'s shot #" + std::to_string(i) + " hit nothing.\n");
+                battlefield->getLogger()->log(self.getName(), "'s shot #", i, " hit nothing.\n");
             }
         }
 
     }
-    else if(getShells() > 0) {
-        subShells() ;
-        battlefield->getLogger()->log(name + " is low on shells, switching to normal shooting.\n") ;
-        battlefield->getLogger()->log(name + " fires at (" + std::to_string(targetX) + ", " + std::to_string(targetY) + ")\n") ;
-
-        for (Robot* other : battlefield->getRobots()) {
-            if (other != this && other->isAlive() && other->getX() == targetX && other->getY() == targetY) {
-
-                battlefield->getLogger()->log(name + " hits " + other->getName() + "!\n") ;
-                other->takeDamage();         //deal damage as usual
-                addUpgradePoints() ;
-                break;
-            }
+    else if(self.getShells() > 0) {
+        self.subShells() ;
+        battlefield->getLogger()->log(self.getName(), " is low on shells, switching to normal shooting.\n") ;
+        if (!battlefield->canShoot(&self, targetX, targetY))
+            return;
+        battlefield->getLogger()->log(self.getName(), " fires at (", targetX, ", ", targetY, ")\n") ;
+        if (Robot* other = battlefield->robotAt(targetX, targetY, self.getTeam())) {
+            battlefield->getLogger()->log(self.getName(), " hits ", other->getName(), "!\n") ;
+            other->takeDamage();         //deal damage as usual
+            self.addUpgradePoints() ;
         }
     }
     else {
-        battlefield->getLogger()->log(name + " is out of shells and self-destructs!\n") ;
-        kill();
+        battlefield->getLogger()->log(self.getName(), " is out of shells and self-destructs!\n") ;
+        self.kill();
     }
 }
 
-void ScoutBot::look(int dx, int dy) {
+void ScoutLook::look(GenericRobot& self, int dx, int dy) {
+    Battlefield* battlefield = self.getBattlefield() ;
+
     if(remainingScans > 0) {
-        battlefield->getLogger()->log(getName() + " is looking at the entire battlefield.\n") ;
+        battlefield->noteAction(ACTION_LOOK, &self) ;
+        battlefield->getLogger()->log(self.getName(), " is looking at the entire battlefield.\n") ;
         for(Robot* other : battlefield->getRobots()) {
-            if(other != this && other->isAlive()) {
-                battlefield->getLogger()->log(getName() + " found " + other->getName() + " at (" + std::to_string(other->getX()) + "," + std::to_string(other->getY()) + ")\n") ;
+            if(other != &self && other->isAlive() && !self.isTeamMate(other)) {
+                battlefield->getLogger()->log(self.getName(), " found ", other->getName(), " at (", other->getX(), ",", other->getY(), ")\n") ;
             }
         }
         remainingScans-- ;
     }
     else {
-        int targetX = getX() + dx ;
-        int targetY = getY() + dy ;
+        int targetX = self.getX() + dx ;
+        int targetY = self.getY() + dy ;
         if(!battlefield->isInside(targetX , targetY))
             return ;
 
-        battlefield->getLogger()->log(getName() + " tries to perform scan but no scans remaining. Proceed with normal looking.\n") ;
+        if(self.getTeam() != 0 && battlefield->hasTeams()) {
+            battlefield->getLogger()->log(self.getName(), " tries to perform scan but no scans remaining. Proceed with normal looking.\n") ;
+            self.teamLook() ;
+            return ;
+        }
+        battlefield->noteAction(ACTION_LOOK, &self) ;
 
+        battlefield->getLogger()->log(self.getName(), " tries to perform scan but no scans remaining. Proceed with normal looking.\n") ;
 
-        std::vector<std::pair<int,int>> lookAreas ;
+
+        std::pmr::vector<std::pair<int,int>> lookAreas(battlefield->getArena()) ;
 
         for (int dx = -1; dx <= 1; ++dx) {
             for (int dy = -1; dy <= 1; ++dy) {
@@ -1349,14 +582,16 @@ void ScoutBot::look(int dx, int dy) {
             }
         }
 
-        battlefield->getLogger()->log(getName() + " is looking at (" + std::to_string(targetX) + ", " + std::to_string(targetY) + ")\n") ;
+        battlefield->getLogger()->log(self.getName(), " is looking at (", targetX, ", ", targetY, ")\n") ;
+        if(!battlefield->mayHaveRobotAround(targetX, targetY, &self))
+            return ;
 
-        std::vector<std::pair<int,int>> foundRobot ;
+        std::pmr::vector<std::pair<int,int>> foundRobot(battlefield->getArena()) ;
 
         for(Robot* other : battlefield->getRobots()) {
             for(std::pair<int,int>& lookArea : lookAreas) {
-                if(other && other != this && other->isAlive() && other->getX() == lookArea.first && other->getY() == lookArea.second) {
-                    battlefield->getLogger()->log(getName() + " found " + other->getName() + " at (" + std::to_string(other->getX()) + "," + std::to_string(other->getY()) + ")\n") ;
+                if(other && other != &self && other->isAlive() && !self.isTeamMate(other) && other->getX() == lookArea.first && other->getY() == lookArea.second) {
+                    battlefield->getLogger()->log(self.getName(), " found ", other->getName(), " at (", other->getX(), ",", other->getY(), ")\n") ;
                     foundRobot.push_back({other->getX() , other->getY()}) ;
                 }
             }
@@ -1364,72 +599,85 @@ void ScoutBot::look(int dx, int dy) {
     }
 }
 
-void TrackerBot::look(int dx, int dy) {
-    int targetX = getX() + dx;
-    int targetY = getY() + dy;
+void TrackerLook::look(GenericRobot& self, int dx, int dy) {
+    Battlefield* battlefield = self.getBattlefield() ;
+
+    int targetX = self.getX() + dx;
+    int targetY = self.getY() + dy;
 
     if (!battlefield->isInside(targetX, targetY))
         return;
 
-    battlefield->getLogger()->log(getName() + " is looking at (" +
-        std::to_string(targetX) + ", " + std::to_string(targetY) + ")\n");
+    auto track = [&](Robot* other) {                    // Track if not already tracked
+        auto tracked = trackedNameIds.begin() + (TRACKERS - remainingTracker) ;
+        if (remainingTracker > 0 && std::find(trackedNameIds.begin(), tracked, other->getNameId()) == tracked) {
+            *tracked = other->getNameId() ;
+            remainingTracker--;
+            battlefield->getLogger()->log(self.getName(), " put a tracker on ",
+                other->getName(), ". Remaining tracker left: ",
+                remainingTracker, "\n");
+        }
+    };
 
-    // Build list of 3x3 adjacent coordinates around the target position
-    std::vector<std::pair<int, int>> lookAreas;
-    for (int offX = -1; offX <= 1; ++offX) {
-        for (int offY = -1; offY <= 1; ++offY) {
-            int lx = targetX + offX;
-            int ly = targetY + offY;
-            if (battlefield->isInside(lx, ly)) {
-                lookAreas.emplace_back(lx, ly);
+    std::pmr::vector<Robot*> seen(battlefield->getArena()) ;
+    if (self.teamLook(&seen)) {                         // on a team : trackers go on the enemies the team sees
+        for (Robot* other : seen)
+            track(other) ;
+    }
+    else {
+        battlefield->noteAction(ACTION_LOOK, &self) ;
+
+        battlefield->getLogger()->log(self.getName(), " is looking at (",
+            targetX, ", ", targetY, ")\n");
+
+        // Build list of 3x3 adjacent coordinates around the target position
+        std::pmr::vector<std::pair<int, int>> lookAreas(battlefield->getArena());
+        for (int offX = -1; offX <= 1; ++offX) {
+            for (int offY = -1; offY <= 1; ++offY) {
+                int lx = targetX + offX;
+                int ly = targetY + offY;
+                if (battlefield->isInside(lx, ly)) {
+                    lookAreas.emplace_back(lx, ly);
+                }
             }
         }
-    }
 
-    // perform normal look and put tracker if got tracker remainings.
-    for (Robot* other : battlefield->getRobots()) {
-        if (!other || other == this || !other->isAlive())
-            continue;
-
-        for (const auto& area : lookAreas) {
-            if (other->getX() == area.first && other->getY() == area.second) {
-                battlefield->getLogger()->log(getName() + " found " +
-                    other->getName() + " at (" +
-                    std::to_string(other->getX()) + "," +
-                    std::to_string(other->getY()) + ")\n");
-
-                // Track if not already tracked
-                if (remainingTracker > 0 &&
-                    std::find(trackedRobotName.begin(), trackedRobotName.end(), other->getName()) == trackedRobotName.end()) {
-                    trackedRobotName.push_back(other->getName());
-                    remainingTracker--;
-                    battlefield->getLogger()->log(getName() + " put a tracker on " +
-                        other->getName() + ". Remaining tracker left: " +
-                        std::to_string(remainingTracker) + "\n");
+        // perform normal look and put tracker if got tracker remainings. skipped when the bitboard shows nobody around
+        static const std::vector<Robot*> nobody ;
+        const std::vector<Robot*>& candidates = battlefield->mayHaveRobotAround(targetX, targetY, &self) ? battlefield->getRobots() : nobody ;
+        for (Robot* other : candidates) {
+            if (!other || other == &self || !other->isAlive() || self.isTeamMate(other))
+                continue;
+
+            for (const auto& area : lookAreas) {
+                if (other->getX() == area.first && other->getY() == area.second) {
+                    battlefield->getLogger()->log(self.getName(), " found ",
+                        other->getName(), " at (",
+                        other->getX(), ",",
+                        other->getY(), ")\n");
+                    track(other) ;
+                    break; // Already matched in one area
                 }
-                break; // Already matched in one area
             }
         }
     }
 
-
-
     // Log tracked robots
     for(Robot* robot : battlefield->getRobots()) {
-        for (std::string& trackedName : trackedRobotName) {
-            if (robot && robot->isAlive() && robot->getName() == trackedName) {
-                battlefield->getLogger()->log(getName() + " sees "
-                                              + robot->getName() + " at ("
-                                              + std::to_string(robot->getX()) + ","
-                                              + std::to_string(robot->getY()) + ") from the tracker.\n");
+        for (int i = 0 ; i < TRACKERS - remainingTracker ; i++) {
+            if (robot && robot->isAlive() && robot->getNameId() == trackedNameIds[i]) {
+                battlefield->getLogger()->log(self.getName(), " sees ",
+                                               robot->getName(), " at (",
+                                               robot->getX(), ",",
+                                               robot->getY(), ") from the tracker.\n");
             }
         }
     }
 }
 
-
 Logger::Logger(const std::string& filename) {
-    logFile.open(filename, std::ios::out);
+    if(!filename.empty())
+        logFile.open(filename, std::ios::out);
 }
 
 Logger::~Logger() {
@@ -1438,216 +686,798 @@ Logger::~Logger() {
 }
 
 void Logger::log(const std::string& message) {
+    if(!enabled)
+        return ;
+    if(captured) {
+        captured->append(message) ;
+        return ;
+    }
     std::cout << message ;
     if (logFile.is_open()) {
         logFile << message ;
     }
 }
 
-void Battlefield::loadFromFile(const std::string& filename) {
-    std::ifstream file(filename);
-    std::string line;
-    while (getline(file, line)) {
-        if (line.find("M by N") != std::string::npos) {
-            std::istringstream iss(line);
-            std::string dummy;
-            int newCols, newRows;
+void Logger::emit(std::string_view text) {
+    std::cout.write(text.data(), text.size()) ;
+    if (logFile.is_open())
+        logFile.write(text.data(), text.size()) ;
+}
 
-            //M by N : 40 50
-            iss >> dummy >> dummy >> dummy >> dummy >> newRows >> newCols;
-            setCols(newCols) ;
-            setRows(newRows) ;
-            grid = std::vector<std::vector<std::string>>(rows, std::vector<std::string>(cols, "+___"));
+const std::string& robotKindName(RobotKind kind) {
+    static const std::string names[] = {
+#define X(kind) #kind,
+        ROBOT_KINDS(X)
+#undef X
+    };
+    return names[static_cast<int>(kind)] ;
+}
 
-        } else if (line.find("steps:") != std::string::npos) {
-            std::istringstream iss(line);
-            std::string dummy;
-            iss >> dummy >> steps;
-        } else if (line.find("GenericRobot") != std::string::npos) {
-            std::istringstream iss(line);
-            std::string type, name;
-            std::string sx, sy;
-            iss >> type >> name >> sx >> sy;
+RobotKind robotKindFromName(std::string_view name) {
+    for(int i = 0 ; i < static_cast<int>(RobotKind::COUNT) ; i++) {
+        if(robotKindName(RobotKind(i)) == name)
+            return RobotKind(i) ;
+    }
+    return RobotKind::GenericRobot ;
+}
 
-            if(name.size() < 3)
-                name = name + "_" ;
+std::atomic<std::string*> NameTable::chunks[NameTable::MAX_CHUNKS] ;
+std::unordered_map<std::string_view, uint32_t> NameTable::ids ;
+uint32_t NameTable::count = 0 ;
+std::mutex NameTable::mutex ;
+
+uint32_t NameTable::intern(std::string_view name) {
+    std::lock_guard<std::mutex> lock(mutex) ;
+
+    auto found = ids.find(name) ;
+    if(found != ids.end())
+        return found->second ;
+
+    bool full = count == FULL_ID ;
+    uint32_t id = full ? FULL_ID : count++ ;
+    std::string* chunk = chunks[id >> CHUNK_BITS].load(std::memory_order_relaxed) ;
+    if(!chunk) {
+        chunk = new std::string[CHUNK_SIZE] ;                  //lives for the whole process
+        chunks[id >> CHUNK_BITS].store(chunk, std::memory_order_release) ;
+    }
+    if(full) {                                                  //no chunk left, the name is not stored
+        if(chunk[id & (CHUNK_SIZE - 1)].empty()) {
+            chunk[id & (CHUNK_SIZE - 1)] = "?" ;
+            std::cerr << "Name table full (" << FULL_ID << " names). Further names show as ?\n" ;
+        }
+        return id ;
+    }
+    chunk[id & (CHUNK_SIZE - 1)] = std::string(name) ;
+    ids.emplace(chunk[id & (CHUNK_SIZE - 1)], id) ;            //key views the stored string, which never moves
+    return id ;
+}
 
+bool Battlefield::loadFromFile(const std::string& filename) {
+    ScenarioReader reader(filename) ;
+    if(!reader.isOpen()) {
+        getLogger()->log("Cannot open ", filename, "\n") ;
+        return false ;
+    }
+    return loadScenario(reader) ;
+}
 
+bool Battlefield::loadFromText(std::string_view text) {
+    ScenarioReader reader = ScenarioReader::fromText(text) ;
+    return loadScenario(reader) ;
+}
 
-            int x = sx == "random" ? (cols > 0 ? rand() % cols : 0) : std::stoi(sx);
-            int y = sy == "random" ? (rows > 0 ? rand() % rows : 0) : std::stoi(sy);
+bool Battlefield::loadScenario(ScenarioReader& reader) {
 
-            while(true) {
-                if(isInside(x, y) && !isOccupied(x, y)) {
-                    Robot* robot = new GenericRobot(type, name, x, y, this);
-                    *this << robot ;  //operator overloading
+    std::vector<bool> taken(rows * cols, false) ;                  //O(1) occupancy while placing
+    int freeCells = rows * cols ;
+    for(Robot* robot : robots) {
+        if(robot->isAlive() && isInside(robot->getX(), robot->getY()) && !taken[robot->getY() * cols + robot->getX()]) {
+            taken[robot->getY() * cols + robot->getX()] = true ;
+            freeCells-- ;
+        }
+    }
 
-                    grid[y][x] = name.substr(0,3);
-                    getLogger()->log("Loaded robot " + name + " at (" + std::to_string(x) + ", " + std::to_string(y) + ")\n");
-                    break ;
-                }
-                else {
-                    getLogger()->log("Invalid Position. Randomizing new position\n") ;
+    int terrainRow = -1 ;                                            //next row of a "terrain:" section
+    std::string scriptName, scriptSource ;                           //"script:" block being read
+    ScenarioReader::Line line ;
+    while(reader.next(line)) {
+        if(line.kind == ScenarioReader::INVALID) {
+            getLogger()->log("Scenario error at line ", reader.getLineNumber(), ": ", line.error, "\n") ;
+            return false ;
+        }
+        else if(line.kind == ScenarioReader::SIZE) {
+            setCols(line.cols) ;
+            setRows(line.rows) ;
+            taken.assign(rows * cols, false) ;                         //board itself is formatted by display()
+            freeCells = rows * cols ;
+        }
+        else if(line.kind == ScenarioReader::STEPS) {
+            steps = line.value ;
+        }
+        else if(line.kind == ScenarioReader::ROBOTS) {
+            robots.reserve(robots.size() + line.value) ;
+        }
+        else if(line.kind == ScenarioReader::ROBOT) {
+            int x = line.randomX ? (cols > 0 ? nextRandom() % cols : 0) : line.x ;
+            int y = line.randomY ? (rows > 0 ? nextRandom() % rows : 0) : line.y ;
+            const ScriptProgram* script = nullptr ;
+            if(!line.script.empty() && !(script = findScript(line.script)))
+                getLogger()->log("Unknown script ", line.script, " for robot ", line.name, ". Using the built-in turn\n") ;
+            placeLoadedRobot(line.type, line.name, x, y, line.team, taken, freeCells, script) ;
+        }
+        else if(line.kind == ScenarioReader::SCRIPT) {
+            scriptName.assign(line.name) ;
+            scriptSource.clear() ;
+        }
+        else if(line.kind == ScenarioReader::SCRIPT_LINE) {
+            scriptSource.append(line.cells).append("\n") ;
+        }
+        else if(line.kind == ScenarioReader::SCRIPT_END) {
+            auto program = std::make_shared<ScriptProgram>(scriptName) ;
+            std::string error ;
+            if(program->assemble(scriptSource, error))
+                scripts.push_back(std::move(program)) ;
+            else
+                getLogger()->log("Script ", scriptName, ", ", error, "\n") ;
+        }
+        else if(line.kind == ScenarioReader::TERRAIN) {
+            terrainRow = 0 ;
+        }
+        else if(line.kind == ScenarioReader::TERRAIN_ROW && terrainRow >= 0 && terrainRow < rows) {
+            for(int x = 0 ; x < cols && x < int(line.cells.size()) ; x++) {
+                TerrainType type = Terrain::fromChar(line.cells[x]) ;
+                setTerrain(x, terrainRow, type) ;
+                if(type == TERRAIN_WALL && !taken[terrainRow * cols + x]) {     //robots listed later avoid walls
+                    taken[terrainRow * cols + x] = true ;
+                    freeCells-- ;
                 }
-
-                x = rand() % cols ;
-                y = rand() % rows ;
             }
+            terrainRow++ ;
         }
     }
-    getLogger()->log("Finished loading file. Battlefield size: " + std::to_string(cols) + "x" + std::to_string(rows)
-                      + ", Steps: " + std::to_string(steps) + ", Robots: " + std::to_string(robots.size()) + "\n") ;
-    display() ;
+
+    std::vector<Robot*> walled ;                                     //listed above the terrain that walled them in
+    for(Robot* robot : robots)
+        if(terrain.isWall(robot->getX(), robot->getY()))
+            walled.push_back(robot) ;
+    for(Robot* robot : walled) {
+        if(freeCells <= 0) {
+            getLogger()->log("Battlefield is full. Cannot load robot ", robot->getName(), "\n") ;
+            removeRobot(robot) ;
+            delete robot ;
+            continue ;
+        }
+        int x, y ;
+        do {
+            x = nextRandom() % cols ;
+            y = nextRandom() % rows ;
+        } while(taken[y * cols + x]) ;
+        taken[y * cols + x] = true ;
+        freeCells-- ;
+        robot->setPosition(x, y) ;
+        getLogger()->log(robot->getName(), " is inside a wall. Moved to (", x, ", ", y, ")\n") ;
+    }
+    getLogger()->log("Finished loading file. Battlefield size: ", cols, "x", rows,
+                       ", Steps: ", steps, ", Robots: ", robots.size(), "\n") ;
+    //initial board is rendered by runSimulation()
+    return true ;
+}
+
+void Battlefield::placeLoadedRobot(std::string_view type, std::string_view robotName, int x, int y, int team, std::vector<bool>& taken, int& freeCells,
+                                   const ScriptProgram* script) {
+    std::string name(robotName) ;
+    if(name.size() < 3)
+        name = name + "_" ;
+
+    if(freeCells <= 0) {
+        getLogger()->log("Battlefield is full. Cannot load robot ", name, "\n") ;
+        return ;
+    }
+
+    while(true) {
+        if(isInside(x, y) && !taken[y * cols + x]) {
+            Robot* robot = buildRobot(robotKindFromName(type), name, x, y);
+            robot->setTeam(team) ;
+            robot->setScript(script) ;
+            if(team != 0)
+                teamsInPlay = true ;
+            *this << robot ;  //operator overloading
+
+            taken[y * cols + x] = true ;
+            freeCells-- ;
+            getLogger()->log("Loaded robot ", name, " at (", x, ", ", y, ")\n");
+            return ;
+        }
+        else {
+            getLogger()->log("Invalid Position. Randomizing new position\n") ;
+        }
+
+        x = nextRandom() % cols ;
+        y = nextRandom() % rows ;
+    }
+}
+
+const ScriptProgram* Battlefield::findScript(std::string_view name) const {
+    for(auto it = scripts.rbegin() ; it != scripts.rend() ; ++it)
+        if((*it)->getName() == name)
+            return it->get() ;
+    return nullptr ;
 }
 
 void Battlefield::runSimulation() {
 
+    if(pipelineDepth > 0 && getLogger()->isEnabled()) {
+        pipeline.start(getLogger(), &terrain, pipelineDepth) ;
+        getLogger()->capture(&pendingLog) ;
+        queueFrame(true, false) ;            //initial board, deferred from loadFromFile()
+    }
+    else
+        display() ;                          //initial board, deferred from loadFromFile()
+    publishFrame(0) ;
+
+    PhaseTimer timer(metrics) ;
+    stepsRun = 0 ;
+    if(tickRate > 0)
+        ticks.start(tickRate) ;
     for (int step = 0; step < steps && robots.size() > 1; ++step) {
-        getLogger()->log("\nStep: " + std::to_string(step + 1) + "\n");
+        if(ticks.isEnabled())
+            renderStep = ticks.waitTick() ;
+        bool more = runStep(step, timer) ;
+        if(ticks.isEnabled())
+            ticks.endStep() ;
+        if(!more)
+            break ;
+    }
+    renderStep = true ;
+    if(pipeline.isRunning()) {
+        if(!pendingLog.empty())
+            queueFrame(false, false) ;       //whatever the last step logged after its board
+        pipeline.finish() ;
+        getLogger()->capture(nullptr) ;
+    }
+    if(ticks.isEnabled()) {
+        std::string summary ;
+        ticks.report(summary) ;
+        getLogger()->log(summary) ;
+    }
+
+    if(metrics.isEnabled() && !metrics.write())
+        getLogger()->log("Failed to write step metrics\n") ;
+    replay.close() ;
+}
 
-        reviveOne() ;                         //try to revive one robot from the queue
+bool Battlefield::runStep(int step, PhaseTimer& timer) {
+    stepsRun = step + 1 ;
+    getLogger()->log("\nStep: ", step + 1, "\n");
 
-        for(Robot* robot : robots) {         //each robot take turn
-            if (robot->isAlive()) {
-                robot->takeTurn();
-            }
-        }
+    timer.start() ;
 
-        for(Robot* robot : robots) {         //find ded robot and send them to graveyard queue
-            if(!robot->isAlive()) {
-                if (std::find(graveyard.begin(), graveyard.end(), robot) == graveyard.end()) {   //check if the robot is already waiting inside the queue
-                    getLogger()->log(robot->getName() + " is ded. Sent to graveyard.\n") ;
-                    enterGraveyard(robot) ;
-                }
+    if(rosterSortInterval > 0 && step % rosterSortInterval == 0)
+        sortRoster() ;
+    timer.done(PHASE_ROSTER_SORT) ;
+
+    reviveOne() ;                         //try to revive one robot from the queue
+    robots.compact() ;
+    timer.done(PHASE_REVIVE) ;
+
+    if(bulkRandom) {                      //every robot's draws for this step, slot = roster index
+        stepRandom.generate(step, robots.size()) ;
+        for(size_t i = 0 ; i < robots.size() ; i++)
+            robots[i]->setRollSlot(i) ;
+    }
+
+    if(aiMode == AI_FLOW)
+        refreshFlowField() ;              //positions as of the start of the step
+    if(teamsInPlay)
+        visibility.build(robots.all()) ;
+
+    runTurns(step, timer.isCounted()) ;  //each robot take turn
+    timer.done(PHASE_TURNS) ;
+
+    for(Robot* robot : robots) {         //find ded robot and send them to graveyard queue
+        if(!robot->isAlive()) {
+            if (std::find(graveyard.begin(), graveyard.end(), robot->getHandle()) == graveyard.end()) {   //check if the robot is already waiting inside the queue
+                getLogger()->log(robot->getName(), " is ded. Sent to graveyard.\n") ;
+                enterGraveyard(robot) ;
             }
         }
+    }
+    timer.done(PHASE_GRAVEYARD) ;
 
 
-        for(Robot* robot : robots) {          //upgrade all robot that can be upgrade
-            if (robot->isAlive() && (!robot->getUpgradeFirst() || !robot->getUpgradeSecond() || !robot->getUpgradeThird()) && (robot->getUpgradePoints() > 0)) {
-                upgrade(robot);
-            }
+    for(size_t i = 0, count = robots.size() ; i < count ; i++) {      //upgrade all robot that can be upgrade
+        Robot* robot = robots[i] ;       //upgraded robots land past count, the ones they replace leave a hole
+        if (robot && robot->isAlive() && (!robot->getUpgradeFirst() || !robot->getUpgradeSecond() || !robot->getUpgradeThird()) && (robot->getUpgradePoints() > 0)) {
+            upgrade(robot);
         }
+    }
+    robots.compact() ;
+    timer.done(PHASE_UPGRADE) ;
+
+    publishFrame(step + 1) ;
 
-        display();
+    if(pipeline.isRunning()) {
+        queueFrame(renderStep, renderStep) ;    //board and graveyard are written by the render thread
+        timer.done(PHASE_DISPLAY) ;
+    }
+    else {
+        if(renderStep)
+            display();
+        timer.done(PHASE_DISPLAY) ;
+    }
 
-        getLogger()->log("Graveyard : ") ;                    //display graveyard list
-        for(Robot* robot : graveyard) {
-            getLogger()->log("[" + robot->getName() + "] ") ;
+    if(getLogger()->isEnabled() && !pipeline.isRunning() && renderStep) {
+        getLogger()->log("Graveyard : ") ;                //display graveyard list
+        for(RobotHandle dead : graveyard) {
+            getLogger()->log("[", robots.get(dead)->getName(), "] ") ;
         }
 
         getLogger()->log("\n") ;
+    }
+    timer.done(PHASE_GRAVEYARD_PRINT) ;
 
-        int robotCounter = 0 ;
+    int robotCounter = 0 ;
+    for(Robot* robot : robots) {
+        if(robot->isAlive())
+            robotCounter++ ;
+    }
+    timer.done(PHASE_ALIVE_COUNT) ;
+    metrics.endStep() ;
+
+    if(robotCounter == 1 && graveyard.empty()) {
+        getLogger()->log("Only 1 robot left\n") ;
+        arena.reset() ;
+        return false ;
+    }
+    arena.reset() ;                        //nothing allocated during the step outlives it
+    return true ;
+}
+
+int Battlefield::advance(int count) {
+    PhaseTimer timer(metrics) ;
+    int ran = 0 ;
+    while(ran < count && stepsRun < steps && robots.size() > 1) {
+        ran++ ;
+        if(!runStep(stepsRun, timer))
+            break ;
+    }
+    return ran ;
+}
+
+/*Robot is a virtual base, so T* cannot be static_cast from Robot* directly. with the hand written classes a robot of
+kind T is a complete T object, and dynamic_cast<void*> only reads its offset from the vtable. policy robots bind their
+calls inside their own takeTurn()*/
+template<class T> static void runTurnBatch(const std::vector<Robot*>& robots, RobotModel model) {
+    for(Robot* robot : robots) {
+        if(!robot->isAlive())
+            continue ;
+        if(model == MODEL_CLASSES)
+            GenericRobot::takeTurnDirect<T>(static_cast<T*>(dynamic_cast<void*>(robot))) ;
+        else
+            robot->takeTurn() ;
+    }
+}
+
+/*turns then run, and the spatial buckets are scanned, roughly along the board instead of in load order. ties keep
+their roster order so the result only depends on positions and the previous order*/
+void Battlefield::sortRoster() {
+    std::pmr::vector<uint64_t> keys(&arena) ;       //Morton index above, roster position below
+    keys.reserve(robots.size()) ;
+    for(size_t i = 0 ; i < robots.size() ; i++)
+        keys.push_back(uint64_t(mortonIndex(robots[i]->getX(), robots[i]->getY())) << 32 | i) ;
+    if(std::is_sorted(keys.begin(), keys.end()))
+        return ;                                    //nobody moved far enough, keep the turn buckets
+    std::sort(keys.begin(), keys.end()) ;
+
+    std::pmr::vector<Robot*> previous(robots.begin(), robots.end(), &arena) ;
+    for(size_t i = 0 ; i < robots.size() ; i++)
+        robots[i] = previous[uint32_t(keys[i])] ;
+    robots.reindex() ;
+    spatial.sortBuckets() ;
+    rosterVersion++ ;
+}
+
+void Battlefield::rebuildTurnBuckets() {
+    turnBuckets.resize(static_cast<int>(RobotKind::COUNT)) ;
+    for(std::vector<Robot*>& bucket : turnBuckets)
+        bucket.clear() ;
+    for(Robot* robot : robots)
+        turnBuckets[static_cast<int>(robot->getKind())].push_back(robot) ;
+    bucketVersion = rosterVersion ;
+}
+
+void Battlefield::runTurns(int step, bool counted) {
+    PerfSample before, after ;
+
+    if(dispatchMode == DISPATCH_ROSTER) {
         for(Robot* robot : robots) {
-            if(robot->isAlive())
-                robotCounter++ ;
+            if (robot->isAlive()) {
+                if(counted) {
+                    RobotKind kind = robot->getKind() ;
+                    metrics.readPerf(before) ;
+                    robot->takeTurn();
+                    metrics.readPerf(after) ;
+                    metrics.recordTypePerf(robotKindName(kind), before, after) ;
+                }
+                else {
+                    robot->takeTurn();
+                }
+            }
         }
+        return ;
+    }
 
-        if(robotCounter == 1 && graveyard.empty()) {
-            getLogger()->log("Only 1 robot left\n") ;
-            break;
+    if(bucketVersion != rosterVersion)                 //the roster only changes on load, revive and upgrade
+        rebuildTurnBuckets() ;
+
+    //groups go in kind order rotated by the step number, robots inside a group keep roster order.
+    //the order is deterministic and no kind always moves first
+    const int kinds = static_cast<int>(RobotKind::COUNT) ;
+    for(int i = 0 ; i < kinds ; i++) {
+        int kind = (step + i) % kinds ;
+        const std::vector<Robot*>& bucket = turnBuckets[kind] ;
+        if(bucket.empty())
+            continue ;
+
+        if(counted)
+            metrics.readPerf(before) ;
+        switch(RobotKind(kind)) {
+#define X(kind) case RobotKind::kind: runTurnBatch<kind>(bucket, robotModel) ; break ;
+            ROBOT_KINDS(X)
+#undef X
+            default: break ;
+        }
+        if(counted) {
+            metrics.readPerf(after) ;
+            metrics.recordTypePerf(robotKindName(RobotKind(kind)), before, after) ;
         }
     }
 }
 
-void Battlefield::display() {
-    grid = std::vector<std::vector<std::string>>(rows, std::vector<std::string>(cols, "+___"));
-    for (auto& robot : robots) {
-        if (robot->isAlive())
-            grid[robot->getY()][robot->getX()] = "+" + robot->getName().substr(0, 3);
+bool Battlefield::addObjective(int x, int y) {
+    if(!isInside(x, y))
+        return false ;
+    objectives.push_back({x, y}) ;
+    return true ;
+}
+
+void Battlefield::refreshFlowField() {
+    flowField.clearSources() ;
+    if(!objectives.empty()) {
+        for(size_t i = 0 ; i < objectives.size() ; i++)
+            flowField.addSource(objectives[i].first, objectives[i].second, UINT32_MAX - i) ;    //never a name id
     }
+    else {
+        for(Robot* robot : robots) {
+            if(robot->isAlive() && isInside(robot->getX(), robot->getY()))
+                flowField.addSource(robot->getX(), robot->getY(), robot->getNameId()) ;
+        }
+    }
+    flowField.build() ;
+}
 
-    getLogger()->log("+___") ;
-    for (int x = 0; x < cols; ++x) {
-        if (x < 10)
-            getLogger()->log("+_" + std::to_string(x) + "_") ;
-        else
-            getLogger()->log("+_" + std::to_string(x)) ;
+bool Battlefield::flowStep(const Robot* robot, int& dx, int& dy) {
+    int x = robot->getX(), y = robot->getY() ;
+    int best = flowField.distance(x, y, robot->getNameId()) ;
+    if(best == FlowField::UNREACHED || best <= (objectives.empty() ? 1 : 0))   //already next to a robot, or on the goal
+        return false ;
+
+    bool found = false ;
+    for(int ny = y - 1 ; ny <= y + 1 ; ny++) {
+        for(int nx = x - 1 ; nx <= x + 1 ; nx++) {
+            if((nx == x && ny == y) || !canEnter(nx, ny))
+                continue ;
+            int distance = flowField.distance(nx, ny, robot->getNameId()) ;
+            if(distance < best) {
+                best = distance ;
+                dx = nx - x ;
+                dy = ny - y ;
+                found = true ;
+            }
+        }
     }
-    getLogger()->log("\n") ;
+    return found ;
+}
 
-    for (int y = 0; y < rows; ++y) {
-        if (y < 10)
-            getLogger()->log("+_" + std::to_string(y) + "_") ;
-        else
-            getLogger()->log("+_" + std::to_string(y)) ;
+void Battlefield::setBulkRandom(bool state) {
+    bulkRandom = state ;
+    if(state) {                          //follows --seed. two statements, so the draw order is fixed
+        uint64_t high = nextRandom() ;
+        uint64_t low = nextRandom() ;
+        stepRandom.seedWith((high << 31) ^ low) ;
+    }
+}
+
+int Battlefield::roll(Robot* robot) {
+    if(!bulkRandom)
+        return nextRandom() ;
+
+    //past its 16 slot draws (or with no slot at all) a robot reads its own overflow stream, keyed by roster slot or,
+    //without one, by handle, so the values never depend on which robots rolled before it
+    uint32_t index = robot->takeRoll() ;
+    int slot = robot->getRollSlot() ;
+    if(slot >= 0 && index < uint32_t(StepRandom::ROLLS_PER_ROBOT))
+        return stepRandom.at(slot, index) ;
+    return stepRandom.overflow(slot >= 0 ? uint32_t(slot) : robot->getHandle().index | 0x80000000u, index) ;
+}
+
+bool Battlefield::startHashTrace(const std::string& filename) {
+    hashTrace.open(filename, std::ios::out | std::ios::trunc) ;
+    seenStates.clear() ;
+    return hashTrace.is_open() ;
+}
+
+uint64_t Battlefield::computeStateHash() const {
+    uint64_t hash = 0 ;
+    for(Robot* robot : robots)
+        hash ^= robot->stateHash() ;
+    return hash ;
+}
+
+bool Battlefield::startSharedExport(const std::string& name, bool keep) {
+    std::vector<uint32_t> nameIds ;                        //names survive revives and upgrades, the roster never grows
+    for(Robot* robot : robots)
+        nameIds.push_back(robot->getNameId()) ;
+    return sharedState.open(name, robots.size(), nameIds, keep) ;
+}
 
-        for (int x = 0; x < cols; ++x) {
-            getLogger()->log(grid[y][x]) ;
+void Battlefield::publishFrame(int step) {
+    if(hashTrace.is_open()) {
+        char line[96] ;
+        auto first = seenStates.emplace(stateHash, step) ;
+        int length = first.second ? snprintf(line, sizeof(line), "%d %016llx", step, (unsigned long long)stateHash)
+                                  : snprintf(line, sizeof(line), "%d %016llx repeat %d", step, (unsigned long long)stateHash, first.first->second) ;
+        uint64_t computed = computeStateHash() ;                     //tracing is for debugging, so check the incremental hash too
+        if(computed != stateHash) {
+            length += snprintf(line + length, sizeof(line) - length, " mismatch %016llx", (unsigned long long)computed) ;
+            getLogger()->log("State hash mismatch at step ", step, "\n") ;
         }
-        getLogger()->log("\n") ;
+        line[length++] = '\n' ;
+        hashTrace.write(line, length) ;
     }
+    if(!replay.isOpen() && !sharedState.isOpen())
+        return ;
+    packRecords(frameRecords) ;
+    if(replay.isOpen())
+        replay.record(step, frameRecords) ;
+    if(sharedState.isOpen())
+        sharedState.publish(step, rows, cols, frameRecords) ;
+}
+
+void Battlefield::queueFrame(bool withBoard, bool withGraveyard) {
+    RenderPipeline::Frame& frame = pipeline.next() ;
+    frame.text.swap(pendingLog) ;            //the slot's old text was written already, keep its capacity
+    pendingLog.clear() ;
+    frame.board = withBoard ;
+    frame.graveyard = withGraveyard ;
+    if(withBoard) {
+        frame.rows = rows ;
+        frame.cols = cols ;
+        packRecords(frame.robots) ;
+    }
+    frame.dead.clear() ;
+    if(withGraveyard)
+        for(RobotHandle dead : graveyard)
+            frame.dead.push_back(robots.get(dead)->getNameId()) ;
+    pipeline.submit() ;
+}
+
+void Battlefield::display() {
+    if(!getLogger()->isEnabled())            //nobody would see the board
+        return ;
+    board.begin(rows, cols, &terrain) ;
+    for (auto& robot : robots) {
+        if (robot->isAlive())
+            board.place(robot->getX(), robot->getY(), robot->getName()) ;
+    }
+    boardText.clear() ;
+    board.write(boardText) ;
+    getLogger()->log(boardText) ;
 }
 
 bool Battlefield::isInside(int x, int y) {
     return x >= 0 && y >= 0 && x < cols && y < rows;
 }
 
-bool Battlefield::isOccupied(int x, int y) {
+bool Battlefield::isOccupied(int x, int y) {                      //walls count as occupied
+    return terrain.isWall(x, y) || robotAt(x, y) != nullptr ;
+}
 
-    for(Robot* robot : robots) {
-        if(robot->isAlive() && robot->getX() == x && robot->getY() == y)
-            return true ;
+bool Battlefield::canEnter(int x, int y) {
+    return isInside(x, y) && !isOccupied(x, y) ;
+}
 
+bool Battlefield::canShoot(Robot* shooter, int targetX, int targetY) {
+    if(!isInside(targetX, targetY)) {
+        getLogger()->log(shooter->getName(), " tried to fire outside the battlefield.\n") ;
+        return false ;
+    }
+    if(shotBlocked(shooter->getX(), shooter->getY(), targetX, targetY)) {
+        getLogger()->log(shooter->getName(), "'s shot at (", targetX, ", ", targetY, ") is blocked by terrain.\n") ;
+        return false ;
     }
+    return true ;
+}
 
-    return false ;
+void Battlefield::setTerrain(int x, int y, TerrainType type) {
+    terrain.set(x, y, type) ;
+    flowField.setBlocked(x, y, type == TERRAIN_WALL) ;
+}
+
+static int divideRounded(int a, int b) {                          //b > 0, halves away from zero
+    return a >= 0 ? (2 * a + b) / (2 * b) : -((-2 * a + b) / (2 * b)) ;
+}
+
+bool Battlefield::shotBlocked(int fromX, int fromY, int toX, int toY) const {
+    if(terrain.empty())
+        return false ;
+    if(terrain.isWall(toX, toY))
+        return true ;
+
+    int dx = toX - fromX, dy = toY - fromY ;
+    int length = std::max(std::abs(dx), std::abs(dy)) ;
+    for(int i = 1 ; i < length ; i++) {
+        int x = fromX + divideRounded(dx * i, length) ;
+        int y = fromY + divideRounded(dy * i, length) ;
+        if(terrain.isWall(x, y) || terrain.isCover(x, y))
+            return true ;
+    }
+    return length > 1 && terrain.isCover(toX, toY) ;
+}
+
+int Battlefield::chargeLength(int x, int y, int stepX, int stepY, int length) const {
+    for(int i = 1 ; i <= length ; i++) {
+        if(terrain.isWall(x + i * stepX, y + i * stepY))
+            return i - 1 ;
+        if(terrain.isSlow(x + i * stepX, y + i * stepY))
+            return i ;
+    }
+    return length ;
 }
 
 void Battlefield::createRobot(Robot* robot) {
-    robots.push_back(robot);
+    while(!identities.insert(robot->getIdentity()).second)         //a name already on the roster
+        robot->setIdentity(stateKey(robot->getIdentity(), STATE_PRESENT, 1)) ;
+    robot->setHandle(robots.insert(robot)) ;
+    stateHash ^= robot->stateHash() ;
+    robot->setHashed(true) ;
+    spatial.insert(robot) ;
+    if(bitboard.isActive())
+        bitboard.add(robot->getX(), robot->getY()) ;
+    rosterVersion++ ;
+}
+
+void Battlefield::removeRobot(Robot* robot) {                       //leaves a hole in the roster until robots.compact()
+    robots.remove(robot->getHandle()) ;
+    identities.erase(robot->getIdentity()) ;
+    stateHash ^= robot->stateHash() ;
+    robot->setHashed(false) ;
+    spatial.erase(robot) ;
+    if(bitboard.isActive())
+        bitboard.remove(robot->getX(), robot->getY()) ;
+    rosterVersion++ ;
+}
+
+void Battlefield::packRecords(std::vector<RobotRecord>& records) {
+    records.resize(robots.size()) ;
+    for(size_t i = 0 ; i < robots.size() ; i++)
+        records[i] = robots[i]->toRecord() ;
 }
 
 int Battlefield::getRows() { return rows ; }
 int Battlefield::getCols() { return cols ; }
 int Battlefield::getSteps() { return steps ; }
-std::vector<Robot*>& Battlefield::getRobots() { return robots; }
+const std::vector<Robot*>& Battlefield::getRobots() const { return robots.all() ; }
 
-void Battlefield::setRows(int row) { rows = row ; }
-void Battlefield::setCols(int col) { cols = col ; }
+void Battlefield::setRows(int row) {
+    rows = row ;
+    resizeBoardIndexes() ;
+}
+
+void Battlefield::setCols(int col) {
+    cols = col ;
+    resizeBoardIndexes() ;
+}
+
+void Battlefield::resizeBoardIndexes() {
+    spatial.reset(cols, rows) ;
+    flowField.reset(cols, rows) ;
+    visibility.reset(cols, rows) ;
+    terrain.reset(cols, rows) ;
+    for(Robot* robot : robots)
+        spatial.insert(robot) ;
+    rebuildBitboard() ;
+}
+
+void Battlefield::rebuildBitboard() {
+    bool small = rows * cols <= bitboardCells ;
+    bitboard.reset(small ? cols : 0, small ? rows : 0) ;
+    if(small) {
+        for(Robot* robot : robots)
+            bitboard.add(robot->getX(), robot->getY()) ;
+    }
+}
+
+void Battlefield::setBitboardLimit(int cells) {
+    bitboardCells = cells ;
+    rebuildBitboard() ;
+}
+
+void Battlefield::noteMove(Robot* robot, int oldX, int oldY) {
+    spatial.move(robot, oldX, oldY) ;
+    if(bitboard.isActive()) {
+        bitboard.remove(oldX, oldY) ;
+        bitboard.add(robot->getX(), robot->getY()) ;
+    }
+}
+
+bool Battlefield::mayHaveRobotAround(int x, int y, const Robot* except) const {
+    if(!bitboard.isActive())
+        return true ;
+    int cells = bitboard.countAround(x, y) ;
+    if(except && std::abs(except->getX() - x) <= 1 && std::abs(except->getY() - y) <= 1 && bitboard.robotsOn(except->getX(), except->getY()) == 1)
+        cells-- ;                                  //the only robot on that cell is the one asking
+    return cells > 0 ;
+}
+
+bool Battlefield::mayHaveRobotOnLine(int x0, int y0, int x1, int y1, const Robot* except) const {
+    if(!bitboard.isActive())
+        return true ;
+    if(x0 > x1 || y0 > y1)                         //empty line
+        return false ;
+    int cells = y0 == y1 ? bitboard.countRow(y0, x0, x1) : bitboard.countColumn(x0, y0, y1) ;
+    if(except && except->getX() >= x0 && except->getX() <= x1 && except->getY() >= y0 && except->getY() <= y1
+       && bitboard.robotsOn(except->getX(), except->getY()) == 1)
+        cells-- ;
+    return cells > 0 ;
+}
 void Battlefield::setSteps(int step) { steps = step ; }
 
 void Battlefield::enterGraveyard(Robot* robot) {
-    graveyard.push_back(robot) ;
+    if(events)
+        events->publish(EVENT_DEATH, stepsRun, robot->getNameId(), robot->getX(), robot->getY(), robot->getKind()) ;
+    graveyard.push_back(robot->getHandle()) ;
 }
 
 void Battlefield::reviveOne() {
     if (!graveyard.empty()) {
-        Robot* deadRobot = graveyard.front();
+        Robot* deadRobot = robots.get(graveyard.front());
 
         if(deadRobot->canRevive()) {       //create a new copy of the object then destroy the previous one. because upgraded robot need to degrade back into genericrobot
-            GenericRobot* revivedRobot ;
+            Robot* revivedRobot ;
             int newX ;
             int newY ;
             do {                 //loop eternally until we can get unoccupied space
-                newX = rand() % cols;
-                newY = rand() % rows;
+                newX = nextRandom() % cols;
+                newY = nextRandom() % rows;
 
-                if (!isOccupied(newX, newY)) {
+                if (canEnter(newX, newY)) {
                     deadRobot->subRevivals() ;
 
-                    revivedRobot = new GenericRobot("GenericRobot", deadRobot->getName(), newX, newY, this) ;
+                    revivedRobot = buildRobot(RobotKind::GenericRobot, deadRobot->getName(), newX, newY) ;
                     revivedRobot->setRevivals(deadRobot->getRevivals()) ;
+                    revivedRobot->setTeam(deadRobot->getTeam()) ;
+                    revivedRobot->setScript(deadRobot->getScript()) ;
                     revivedRobot->reset() ;
+                    revivedRobot->setIdentity(deadRobot->getIdentity()) ;     //same robot as far as the state hash goes
+                    graveyard.pop_front();               //kick out of the queue
+                    removeRobot(deadRobot) ;  //kick out of robots vector, first so the revived robot takes over the slot
                     *this << revivedRobot ;
-
-                    graveyard.erase(graveyard.begin());  //kick out of the queue
-                    robots.erase(std::remove(robots.begin(), robots.end(), deadRobot), robots.end());  //kick out of robots vector
+                    noteAction(ACTION_REVIVE, revivedRobot) ;
                     delete deadRobot ;
 
-                    getLogger()->log(revivedRobot->getName() + " has been revived at (" + std::to_string(newX) + "," + std::to_string(newY) + ")"
-                                     + ". Remaining revivals : " + std::to_string(revivedRobot->getRevivals()) + "\n") ;
+                    getLogger()->log(revivedRobot->getName(), " has been revived at (", newX, ",", newY, ")",
+                                      ". Remaining revivals : ", revivedRobot->getRevivals(), "\n") ;
 
 
                     return ;
                 }
-            } while(isOccupied(newX, newY)) ;
+            } while(!canEnter(newX, newY)) ;
         }
         else {
-            getLogger()->log("Attempting to revive " + deadRobot->getName() + " but no revives left. let him ascend.\n") ;
-            graveyard.erase(graveyard.begin());      //if cannot revive just kick out of the queue
-            robots.erase(std::remove(robots.begin(), robots.end(), deadRobot), robots.end());  //kick out of the graveyard
+            getLogger()->log("Attempting to revive ", deadRobot->getName(), " but no revives left. let him ascend.\n") ;
+            graveyard.pop_front();                   //if cannot revive just kick out of the queue
+            removeRobot(deadRobot) ;                 //kick out of the graveyard
             delete deadRobot ;                       //destroy his soul
         }
     }
@@ -1657,150 +1487,120 @@ void Battlefield::upgrade(Robot* robot) {
     Robot* upgradedRobot = createUpgradedRobot(robot);
     if (upgradedRobot) {
         upgradedRobot->setRevivals(robot->getRevivals());
+        upgradedRobot->setTeam(robot->getTeam()) ;
+        upgradedRobot->setScript(robot->getScript()) ;
         upgradedRobot->setUpgradePoints(robot->getUpgradePoints() - 1);
+        upgradedRobot->setIdentity(robot->getIdentity()) ;
+        removeRobot(robot) ;                 //first, so the upgraded robot takes over the freed slot
         *this << upgradedRobot;
-        getLogger()->log(upgradedRobot->getName() + " upgradedRobot to " + upgradedRobot->getType() + "\n");
-        robots.erase(std::remove(robots.begin(), robots.end(), robot), robots.end());
+        noteAction(ACTION_UPGRADE, upgradedRobot) ;
+        getLogger()->log(upgradedRobot->getName(), " upgradedRobot to ", upgradedRobot->getType(), "\n");
         delete robot;
     }
 }
 
 Robot* Battlefield::createUpgradedRobot(Robot* robot) {
-    std::string type = robot->getType();
-    std::string name = robot->getName();
-    int x = robot->getX();
-    int y = robot->getY();
+    //GenericRobot -> HideBot / JumpBot / JuggernautBot -> + a gun -> + a sensor. third tier robots stay as they are
+    static const std::string firstTier[] = {"Hide", "Jump", "Juggernaut"} ;
+    static const std::string secondTier[] = {"Longshot", "Semiauto", "Thirtyshot", "TrueDamage", "Lifesteal"} ;
+    static const std::string thirdTier[] = {"Scout", "Tracker"} ;
 
-    Robot* upgradedRobot = nullptr;
+    const std::string& type = robot->getType();
+    std::string_view base(type.data(), type.size() - 3) ;         //drop "Bot"
+    std::pmr::string next(&arena) ;
+    int tier = 0 ;
 
     if (type == "GenericRobot") {
-        int choice = rand() % 3;
-        if (choice == 0) upgradedRobot = new HideBot("HideBot", name, x, y, this);
-        else if (choice == 1) upgradedRobot = new JumpBot("JumpBot", name, x, y, this);
-        else upgradedRobot = new JuggernautBot("JuggernautBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeFirst(true) ;
-    }
-    else if (type == "HideBot") {
-        int choice = rand() % 5;
-        if (choice == 0) upgradedRobot = new HideLongshotBot("HideLongshotBot", name, x, y, this);
-        else if (choice == 1) upgradedRobot = new HideSemiautoBot("HideSemiautoBot", name, x, y, this);
-        else if (choice == 2) upgradedRobot = new HideThirtyshotBot("HideThirtyshotBot", name, x, y, this);
-        else if (choice == 3) upgradedRobot = new HideTrueDamageBot("HideTrueDamageBot", name, x, y, this);
-        else upgradedRobot = new HideLifestealBot("HideLifestealBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeSecond(true);
-    }
-    else if (type == "JumpBot") {
-        int choice = rand() % 5;
-        if (choice == 0) upgradedRobot = new JumpLongshotBot("JumpLongshotBot", name, x, y, this);
-        else if (choice == 1) upgradedRobot = new JumpSemiautoBot("JumpSemiautoBot", name, x, y, this);
-        else if (choice == 2) upgradedRobot = new JumpThirtyshotBot("JumpThirtyshotBot", name, x, y, this);
-        else if (choice == 3) upgradedRobot = new JumpTrueDamageBot("JumpTrueDamageBot", name, x, y, this);
-        else upgradedRobot = new JumpLifestealBot("JumpLifestealBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeSecond(true);
-    }
-    else if (type == "JuggernautBot") {
-        int choice = rand() % 5;
-        if (choice == 0) upgradedRobot = new JuggernautLongshotBot("JuggernautLongshotBot", name, x, y, this);
-        else if (choice == 1) upgradedRobot = new JuggernautSemiautoBot("JuggernautSemiautoBot", name, x, y, this);
-        else if (choice == 2) upgradedRobot = new JuggernautThirtyshotBot("JuggernautThirtyshotBot", name, x, y, this);
-        else if (choice == 3) upgradedRobot = new JuggernautTrueDamageBot("JuggernautTrueDamageBot", name, x, y, this);
-        else upgradedRobot = new JuggernautLifestealBot("JuggernautLifestealBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeSecond(true);
-    }
-    else if (type == "HideLongshotBot") {
-        int choice = rand() % 2;
-        if (choice == 0) upgradedRobot = new HideLongshotScoutBot("HideLongshotScoutBot", name, x, y, this);
-        else upgradedRobot = new HideLongshotTrackerBot("HideLongshotTrackerBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeThird(true);
-    }
-    if (type == "HideSemiautoBot") {
-        int choice = rand() % 2;
-        if (choice == 0) upgradedRobot = new HideSemiautoScoutBot("HideSemiautoScoutBot", name, x, y, this);
-        else upgradedRobot = new HideSemiautoTrackerBot("HideSemiautoTrackerBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeThird(true);
-    }
-    else if (type == "HideThirtyshotBot") {
-        int choice = rand() % 2;
-        if (choice == 0) upgradedRobot = new HideThirtyshotScoutBot("HideThirtyshotScoutBot", name, x, y, this);
-        else upgradedRobot = new HideThirtyshotTrackerBot("HideThirtyshotTrackerBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeThird(true);
-    }
-    else if (type == "HideTrueDamageBot") {
-        int choice = rand() % 2;
-        if (choice == 0) upgradedRobot = new HideTrueDamageScoutBot("HideTrueDamageScoutBot", name, x, y, this);
-        else upgradedRobot = new HideTrueDamageTrackerBot("HideTrueDamageTrackerBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeThird(true);
-    }
-    else if (type == "HideLifestealBot") {
-        int choice = rand() % 2;
-        if (choice == 0) upgradedRobot = new HideLifestealScoutBot("HideLifestealScoutBot", name, x, y, this);
-        else upgradedRobot = new HideLifestealTrackerBot("HideLifestealTrackerBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeThird(true);
-    }
-    else if (type == "JumpLongshotBot") {
-        int choice = rand() % 2;
-        if (choice == 0) upgradedRobot = new JumpLongshotScoutBot("JumpLongshotScoutBot", name, x, y, this);
-        else upgradedRobot = new JumpLongshotTrackerBot("JumpLongshotTrackerBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeThird(true);
-    }
-    else if (type == "JumpSemiautoBot") {
-        int choice = rand() % 2;
-        if (choice == 0) upgradedRobot = new JumpSemiautoScoutBot("JumpSemiautoScoutBot", name, x, y, this);
-        else upgradedRobot = new JumpSemiautoTrackerBot("JumpSemiautoTrackerBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeThird(true);
-    }
-    else if (type == "JumpThirtyshotBot") {
-        int choice = rand() % 2;
-        if (choice == 0) upgradedRobot = new JumpThirtyshotScoutBot("JumpThirtyshotScoutBot", name, x, y, this);
-        else upgradedRobot = new JumpThirtyshotTrackerBot("JumpThirtyshotTrackerBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeThird(true);
-    }
-    else if (type == "JumpTrueDamageBot") {
-        int choice = rand() % 2;
-        if (choice == 0) upgradedRobot = new JumpTrueDamageScoutBot("JumpTrueDamageScoutBot", name, x, y, this);
-        else upgradedRobot = new JumpTrueDamageTrackerBot("JumpTrueDamageTrackerBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeThird(true);
-    }
-    else if (type == "JumpLifestealBot") {
-        int choice = rand() % 2;
-        if (choice == 0) upgradedRobot = new JumpLifestealScoutBot("JumpLifestealScoutBot", name, x, y, this);
-        else upgradedRobot = new JumpLifestealTrackerBot("JumpLifestealTrackerBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeThird(true);
-    }
-    else if (type == "JuggernautLongshotBot") {
-        int choice = rand() % 2;
-        if (choice == 0) upgradedRobot = new JuggernautLongshotScoutBot("JuggernautLongshotScoutBot", name, x, y, this);
-        else upgradedRobot = new JuggernautLongshotTrackerBot("JuggernautLongshotTrackerBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeThird(true);
-    }
-    else if (type == "JuggernautSemiautoBot") {
-        int choice = rand() % 2;
-        if (choice == 0) upgradedRobot = new JuggernautSemiautoScoutBot("JuggernautSemiautoScoutBot", name, x, y, this);
-        else upgradedRobot = new JuggernautSemiautoTrackerBot("JuggernautSemiautoTrackerBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeThird(true);
-    }
-    else if (type == "JuggernautThirtyshotBot") {
-        int choice = rand() % 2;
-        if (choice == 0) upgradedRobot = new JuggernautThirtyshotScoutBot("JuggernautThirtyshotScoutBot", name, x, y, this);
-        else upgradedRobot = new JuggernautThirtyshotTrackerBot("JuggernautThirtyshotTrackerBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeThird(true);
-    }
-    else if (type == "JuggernautTrueDamageBot") {
-        int choice = rand() % 2;
-        if (choice == 0) upgradedRobot = new JuggernautTrueDamageScoutBot("JuggernautTrueDamageScoutBot", name, x, y, this);
-        else upgradedRobot = new JuggernautTrueDamageTrackerBot("JuggernautTrueDamageTrackerBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeThird(true);
-    }
-    else if (type == "JuggernautLifestealBot") {
-        int choice = rand() % 2;
-        if (choice == 0) upgradedRobot = new JuggernautLifestealScoutBot("JuggernautLifestealScoutBot", name, x, y, this);
-        else upgradedRobot = new JuggernautLifestealTrackerBot("JuggernautLifestealTrackerBot", name, x, y, this);
-        if (upgradedRobot) upgradedRobot->setUpgradeThird(true);
+        next.append(firstTier[nextRandom() % 3]).append("Bot") ;
+        tier = 1 ;
+    }
+    else {
+        for (const std::string& first : firstTier) {
+            if (base == first) {
+                next.append(base).append(secondTier[nextRandom() % 5]).append("Bot") ;
+                tier = 2 ;
+                break ;
+            }
+            for (const std::string& second : secondTier) {
+                if (base.size() == first.size() + second.size() && base.substr(0, first.size()) == first && base.substr(first.size()) == second) {
+                    next.append(base).append(thirdTier[nextRandom() % 2]).append("Bot") ;
+                    tier = 3 ;
+                    break ;
+                }
+            }
+            if (tier)
+                break ;
+        }
     }
 
+    if (tier == 0)
+        return nullptr ;
+
+    Robot* upgradedRobot = buildRobot(robotKindFromName(next), robot->getName(), robot->getX(), robot->getY());
+    if (tier == 1) upgradedRobot->setUpgradeFirst(true) ;
+    else if (tier == 2) upgradedRobot->setUpgradeSecond(true) ;
+    else upgradedRobot->setUpgradeThird(true) ;
+
     return upgradedRobot;
 }
 
+Robot* Battlefield::buildRobot(RobotKind kind, const std::string& name, int x, int y) {
+    if (robotModel == MODEL_POLICY)
+        return createPolicyRobot(kind, name, x, y, this) ;
+
+    switch (kind) {
+#define X(kind) case RobotKind::kind: return new kind(robotKindName(RobotKind::kind), name, x, y, this) ;
+        ROBOT_KINDS(X)
+#undef X
+        default: return nullptr ;
+    }
+}
+
+//every move x fire x look combination is instantiated once, createPolicyRobot picks one from the kind's name
+typedef std::tuple<StepMove, HideMove, JumpMove, JuggernautMove> MovePolicies ;
+typedef std::tuple<BasicFire, ThirtyshotFire, TrueDamageFire, LifestealFire, LongshotFire, SemiautoFire> FirePolicies ;
+typedef std::tuple<BasicLook, ScoutLook, TrackerLook> LookPolicies ;
+
+const int MOVE_POLICY_COUNT = std::tuple_size<MovePolicies>::value ;
+const int FIRE_POLICY_COUNT = std::tuple_size<FirePolicies>::value ;
+const int LOOK_POLICY_COUNT = std::tuple_size<LookPolicies>::value ;
+
+typedef Robot* (*PolicyFactory)(const std::string&, const std::string&, int, int, Battlefield*) ;
+
+template<int M, int F, int L>
+static Robot* makePolicyRobot(const std::string& type, const std::string& name, int x, int y, Battlefield* bf) {
+    return new PolicyRobot<typename std::tuple_element<M, MovePolicies>::type,
+                           typename std::tuple_element<F, FirePolicies>::type,
+                           typename std::tuple_element<L, LookPolicies>::type>(type, name, x, y, bf) ;
+}
+
+template<int... I>
+static std::array<PolicyFactory, sizeof...(I)> policyFactories(std::integer_sequence<int, I...>) {
+    return {{ &makePolicyRobot<I / (FIRE_POLICY_COUNT * LOOK_POLICY_COUNT), (I / LOOK_POLICY_COUNT) % FIRE_POLICY_COUNT, I % LOOK_POLICY_COUNT>... }} ;
+}
+
+static int policyIndex(const std::string& type, const char* const names[], int count) {
+    for (int i = 1 ; i < count ; i++) {
+        if (type.find(names[i]) != std::string::npos)
+            return i ;
+    }
+    return 0 ;
+}
+
+Robot* createPolicyRobot(RobotKind kind, const std::string& name, int x, int y, Battlefield* bf) {
+    static const auto factories = policyFactories(std::make_integer_sequence<int, MOVE_POLICY_COUNT * FIRE_POLICY_COUNT * LOOK_POLICY_COUNT>()) ;
+    static const char* const moveNames[MOVE_POLICY_COUNT] = {"", "Hide", "Jump", "Juggernaut"} ;
+    static const char* const fireNames[FIRE_POLICY_COUNT] = {"", "Thirtyshot", "TrueDamage", "Lifesteal", "Longshot", "Semiauto"} ;
+    static const char* const lookNames[LOOK_POLICY_COUNT] = {"", "Scout", "Tracker"} ;
+
+    const std::string& type = robotKindName(kind) ;
+    int m = policyIndex(type, moveNames, MOVE_POLICY_COUNT) ;
+    int f = policyIndex(type, fireNames, FIRE_POLICY_COUNT) ;
+    int l = policyIndex(type, lookNames, LOOK_POLICY_COUNT) ;
+
+    return factories[(m * FIRE_POLICY_COUNT + f) * LOOK_POLICY_COUNT + l](type, name, x, y, bf) ;
+}
+
 Battlefield& Battlefield::operator<<(Robot* robot) {
         createRobot(robot);
         return *this;
@@ -1810,28 +1610,100 @@ Logger* Battlefield::getLogger() {
     return logger;
 }
 
-Battlefield::~Battlefield() {
-    for (Robot* robot : robots) {
-        delete robot;
-    }
+void Battlefield::seedRandom(unsigned seed) {
+    if(ownRandom)
+        randomState = seed ;
+    else
+        srand(seed) ;
+}
 
-    delete logger ;
+void Battlefield::clear() {
+    for (Robot* robot : robots)
+        delete robot ;
+    robots.clear() ;                          //graveyard entries are still in robots, deleted above
+    identities.clear() ;
+    graveyard.clear() ;
+    scripts.clear() ;
+    stateHash = 0 ;
+    rosterVersion++ ;
+    steps = 0 ;
+    stepsRun = 0 ;
+    teamsInPlay = false ;
+    for (auto& counts : kindActions)
+        counts.fill(0) ;
+    resizeBoardIndexes() ;
 }
 
-/* Starting from here in main()
-xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
-xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
-xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
-xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
-xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
-*/
+uint64_t nameIdentity(std::string_view name) {
+    uint64_t hash = 0xCBF29CE484222325ull ;
+    for(char c : name)
+        hash = (hash ^ uint8_t(c)) * 0x100000001B3ull ;
+    return hash ;
+}
 
-int main() {
+uint64_t Robot::stateHash() const {
+    return stateKey(identity, STATE_PRESENT, 0) ^ stateKey(identity, STATE_KIND, int64_t(kind))
+         ^ stateKey(identity, STATE_POSITION, packPosition(posX, posY)) ^ stateKey(identity, STATE_LIVES, lives)
+         ^ stateKey(identity, STATE_REVIVALS, revivals) ^ stateKey(identity, STATE_SHELLS, shells)
+         ^ stateKey(identity, STATE_UPGRADE_POINTS, upgradePoints) ^ stateKey(identity, STATE_UPGRADES, upgrades)
+         ^ stateKey(identity, STATE_TEAM, team) ;
+}
+
+Robot* Robot::clone(Battlefield* bf) const {
+    //a hand written robot of kind T is a complete T object (see runTurnBatch), PolicyRobot has its own clone
+    const void* complete = dynamic_cast<const void*>(this) ;
+    Robot* copy = nullptr ;
+    switch(kind) {
+#define X(kind) case RobotKind::kind: copy = new kind(*static_cast<const kind*>(complete)) ; break ;
+        ROBOT_KINDS(X)
+#undef X
+        default: break ;
+    }
+    if(copy)
+        copy->battlefield = bf ;
+    return copy ;
+}
+
+std::unique_ptr<Battlefield> Battlefield::fork(unsigned seed) const {
+    std::unique_ptr<Battlefield> copy(new Battlefield(rows, cols, new Logger(""))) ;
+    forkInto(*copy, seed) ;
+    return copy ;
+}
+
+void Battlefield::forkInto(Battlefield& copy, unsigned seed) const {
+    copy.rows = rows ;
+    copy.cols = cols ;
+    copy.bitboardCells = bitboardCells ;
+    copy.clear() ;
+    copy.getLogger()->setEnabled(false) ;
+    copy.steps = steps ;
+    copy.stepsRun = stepsRun ;
+    copy.dispatchMode = dispatchMode ;
+    copy.robotModel = robotModel ;
+    copy.bulkRandom = bulkRandom ;
+    copy.rosterSortInterval = rosterSortInterval ;
+    copy.stepRandom = stepRandom ;
+    copy.aiMode = aiMode ;
+    copy.objectives = objectives ;
+    copy.teamsInPlay = teamsInPlay ;
+    copy.scripts = scripts ;                  //programs are immutable, the cloned robots keep pointing into them
+    copy.terrain = terrain ;                  //flat bitplanes and distances, plain vector copies
+    copy.flowField = flowField ;
+    copy.ownRandom = true ;                   //forks run on other threads, rand() is shared
+    copy.randomState = seed ;
+
+    copy.robots.reserve(robots.size()) ;
+    for(Robot* robot : robots)                //clear() gave the last fork's robots back to this thread's RobotPool
+        copy.createRobot(robot->clone(&copy)) ;
+    for(RobotHandle dead : graveyard)         //graveyard robots are on the roster too, same queue order
+        copy.graveyard.push_back(copy.robots[robots.position(dead)]->getHandle()) ;
+}
 
-    srand(static_cast<unsigned>(time(nullptr)));
-    Battlefield battlefield(MAX_ROWS, MAX_COLS);
-    battlefield.loadFromFile("input.txt");
-    battlefield.runSimulation();
+Battlefield::~Battlefield() {
+    pipeline.finish() ;                    //it still writes through the logger
+    for (Robot* robot : robots) {
+        delete robot;
+    }
 
-    return 0;
+    delete logger ;
 }
@@ -0,0 +1,199 @@
+#include "Battlefield.h"
+#include "MatchService.h"
+#include "Benchmarks.h"
+
+/* Starting from here in main()
+xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+*/
+
+int main(int argc, char* argv[]) {
+
+    if(argc > 1 && std::string(argv[1]) == "--compile") {          //--compile input.txt scenario.bin [seed]
+        if(argc < 4) {
+            std::cout << "usage: " << argv[0] << " --compile <input.txt> <scenario.bin> [seed]\n" ;
+            return 1 ;
+        }
+        uint32_t seed = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 0 ;
+        if(!Battlefield::compileScenario(argv[2], argv[3], seed)) {
+            std::cout << "Failed to compile " << argv[2] << "\n" ;
+            return 1 ;
+        }
+        return 0 ;
+    }
+
+    std::string scenario = "input.txt" ;
+    std::string metricsFile ;
+    int metricsFlush = 0 ;
+    bool perf = false ;
+    DispatchMode dispatch = DISPATCH_ROSTER ;
+    unsigned seed = static_cast<unsigned>(time(nullptr)) ;
+    RobotModel model = MODEL_CLASSES ;
+    bool bulkRng = false ;
+    AiMode ai = AI_RANDOM ;
+    int spectateDelay = -1 ;                                       //-1 = no spectator
+    std::vector<std::pair<int,int>> objectives ;
+    std::string replayFile ;
+    std::string sharedName ;
+    bool keepShared = false ;
+    int keyframeEvery = 100 ;
+    int benchForks = 0, forkDepth = 5 ;
+    int pipelineDepth = 0 ;
+    int sortInterval = 0 ;
+    int tickRate = 0 ;
+    std::string hashTraceFile ;
+    int bitboardCells = BITBOARD_MAX_CELLS ;
+
+    for(int i = 1 ; i < argc ; i++) {
+        std::string arg = argv[i] ;
+        if(arg.rfind("--metrics=", 0) == 0)
+            metricsFile = arg.substr(10) ;                         //step_metrics.json or step_metrics.csv
+        else if(arg.rfind("--metrics-flush=", 0) == 0)
+            metricsFlush = std::atoi(arg.c_str() + 16) ;           //rewrite the metrics file every N steps
+        else if(arg == "--perf")
+            perf = true ;                                          //hardware counters per phase and per robot type
+        else if(arg.rfind("--seed=", 0) == 0)
+            seed = std::strtoul(arg.c_str() + 7, nullptr, 10) ;    //repeatable runs
+        else if(arg == "--robots=policy")
+            model = MODEL_POLICY ;                                 //compile time composed robots
+        else if(arg.rfind("--serve=", 0) == 0) {                  //--serve=SOCKET [--workers=N], see MatchService
+            int workers = std::max(1u, std::thread::hardware_concurrency()) ;
+            for(int j = i + 1 ; j < argc ; j++) {
+                if(std::string(argv[j]).rfind("--workers=", 0) == 0)
+                    workers = std::atoi(argv[j] + 10) ;
+            }
+            MatchService service(arg.substr(8)) ;
+            return service.run(workers) ;
+        }
+        else if(arg.rfind("--bench-models", 0) == 0) {             //--bench-models[=rounds]
+            benchmarkRobotModels(arg.size() > 15 ? std::atoi(arg.c_str() + 15) : 2000) ;
+            return 0 ;
+        }
+        else if(arg.rfind("--bench-forks", 0) == 0) {              //--bench-forks[=N[,DEPTH]] on the loaded scenario
+            char* end = nullptr ;
+            benchForks = arg.size() > 14 ? std::strtol(arg.c_str() + 14, &end, 10) : 1000 ;
+            if(end && *end == ',')
+                forkDepth = std::atoi(end + 1) ;
+        }
+        else if(arg.rfind("--replay=", 0) == 0)
+            replayFile = arg.substr(9) ;                           //record a compact replay of the match
+        else if(arg.rfind("--shm=", 0) == 0)
+            sharedName = arg.substr(6) ;                           //publish every step into this shared memory segment
+        else if(arg == "--shm-keep")
+            keepShared = true ;                                    //leave the segment behind after the match
+        else if(arg == "--shm-view") {                             //--shm-view name
+            if(i + 1 >= argc || !SharedStateExport::view(argv[i + 1], std::cout)) {
+                std::cout << "usage: " << argv[0] << " --shm-view <segment name of a running or kept match>\n" ;
+                return 1 ;
+            }
+            return 0 ;
+        }
+        else if(arg.rfind("--keyframe=", 0) == 0)
+            keyframeEvery = std::atoi(arg.c_str() + 11) ;          //steps between replay keyframes
+        else if(arg == "--replay-view") {                          //--replay-view file step
+            ReplayReader reader ;
+            if(i + 2 >= argc || !reader.open(argv[i + 1])) {
+                std::cout << "usage: " << argv[0] << " --replay-view <replay file> <step>\n" ;
+                return 1 ;
+            }
+            int step = std::min(std::atoi(argv[i + 2]), reader.getLastStep()) ;
+            if(!reader.seek(step))
+                return 1 ;
+            reader.display(std::cout) ;
+            return 0 ;
+        }
+        else if(arg == "--ai=nearest")
+            ai = AI_NEAREST ;                                      //hunt the closest robot instead of moving at random
+        else if(arg == "--ai=flow")
+            ai = AI_FLOW ;                                         //same, walking the shared flow field
+        else if(arg.rfind("--objective=", 0) == 0) {               //--objective=x,y, may repeat
+            char* end ;
+            char* yEnd ;
+            int x = std::strtol(arg.c_str() + 12, &end, 10) ;
+            int y = *end == ',' ? std::strtol(end + 1, &yEnd, 10) : 0 ;
+            if(end == arg.c_str() + 12 || *end != ',' || yEnd == end + 1 || *yEnd) {
+                std::cout << "usage: " << argv[0] << " --objective=<x>,<y>\n" ;
+                return 1 ;
+            }
+            objectives.push_back({x, y}) ;
+        }
+        else if(arg.rfind("--spectate", 0) == 0)                   //--spectate[=microseconds per poll]
+            spectateDelay = arg.size() > 11 ? std::atoi(arg.c_str() + 11) : 0 ;
+        else if(arg.rfind("--hash-trace=", 0) == 0)
+            hashTraceFile = arg.substr(13) ;                       //state hash after every step, to diff two runs
+        else if(arg.rfind("--bitboard-max=", 0) == 0)
+            bitboardCells = std::atoi(arg.c_str() + 15) ;        //largest board (in cells) to keep a bitboard for, 0 = off
+        else if(arg.rfind("--pipeline", 0) == 0)                   //--pipeline[=frames queued for the render thread]
+            pipelineDepth = arg.size() > 11 ? std::atoi(arg.c_str() + 11) : 4 ;
+        else if(arg.rfind("--morton-sort", 0) == 0)                //--morton-sort[=steps between roster re-sorts]
+            sortInterval = arg.size() > 14 ? std::atoi(arg.c_str() + 14) : 16 ;
+        else if(arg.rfind("--realtime=", 0) == 0)
+            tickRate = std::atoi(arg.c_str() + 11) ;            //fixed steps per second, renders give way when late
+        else if(arg == "--bulk-rng")
+            bulkRng = true ;                                       //pre-generate each step's random draws
+        else if(arg == "--dispatch=type")
+            dispatch = DISPATCH_BY_TYPE ;                          //group turns by concrete robot class
+        else
+            scenario = arg ;
+    }
+
+    srand(seed);
+    Battlefield battlefield(MAX_ROWS, MAX_COLS);
+    battlefield.setBitboardLimit(bitboardCells) ;
+    battlefield.setDispatchMode(dispatch) ;
+    battlefield.setPipelineDepth(pipelineDepth) ;
+    battlefield.setRosterSortInterval(sortInterval) ;
+    battlefield.setTickRate(tickRate) ;
+    battlefield.setRobotModel(model) ;
+    battlefield.setBulkRandom(bulkRng) ;
+    battlefield.setAiMode(ai) ;
+    if(perf && metricsFile.empty())
+        metricsFile = "step_metrics.json" ;
+    if(!metricsFile.empty())
+        battlefield.getMetrics().enable(metricsFile, metricsFlush) ;
+    if(perf && !battlefield.getMetrics().enablePerf())
+        battlefield.getLogger()->log("Hardware performance counters are not available. Recording wall time only.\n") ;
+    bool loaded ;
+    if(scenario.size() > 4 && scenario.compare(scenario.size() - 4, 4, ".bin") == 0)
+        loaded = battlefield.loadFromBinary(scenario);
+    else
+        loaded = battlefield.loadFromFile(scenario);
+    if(!loaded)
+        return 1 ;
+    for(const auto& objective : objectives) {                  //checked against the loaded board, not the default one
+        if(!battlefield.addObjective(objective.first, objective.second)) {
+            battlefield.getLogger()->log("Objective ", objective.first, ",", objective.second, " is off the ",
+                                         battlefield.getCols(), "x", battlefield.getRows(), " board\n") ;
+            return 1 ;
+        }
+    }
+    if(benchForks > 0) {
+        battlefield.getLogger()->setEnabled(false) ;
+        benchmarkForks(battlefield, benchForks, forkDepth) ;
+        return 0 ;
+    }
+    if(!replayFile.empty() && !battlefield.startReplay(replayFile, keyframeEvery))
+        battlefield.getLogger()->log("Cannot write replay ", replayFile, "\n") ;
+    if(!hashTraceFile.empty() && !battlefield.startHashTrace(hashTraceFile))
+        battlefield.getLogger()->log("Cannot write hash trace ", hashTraceFile, "\n") ;
+    if(!sharedName.empty() && !battlefield.startSharedExport(sharedName, keepShared))
+        battlefield.getLogger()->log("Cannot create shared memory segment ", sharedName, "\n") ;
+    EventFeed feed ;
+    std::atomic<bool> finished {false} ;
+    std::thread spectator ;
+    if(spectateDelay >= 0) {
+        battlefield.setEventFeed(&feed) ;
+        spectator = std::thread(spectateEvents, std::cref(feed), feed.subscribe(), std::ref(finished), spectateDelay) ;
+    }
+
+    battlefield.runSimulation();
+
+    if(spectator.joinable()) {
+        finished = true ;
+        spectator.join() ;
+    }
+    return 0;
+}